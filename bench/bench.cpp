@@ -0,0 +1,437 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cinttypes>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <new>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../src/world.hpp"
+#include "../src/worldGenerator.hpp"
+#include "../src/physics.hpp"
+#include "../src/entities.hpp"
+#include "../src/entityPhysics.hpp"
+#include "../src/frustum.hpp"
+#include "../src/chunkCodec.hpp"
+#include "../src/editLog.hpp"
+#include "../src/threadPool.hpp"
+
+// Headless benchmarks for the engine. Nothing here touches Vulkan or GLFW, so it runs without a GPU.
+// Every benchmark uses a fixed seed so runs can be compared against each other.
+
+constexpr int32_t seed = 123;
+constexpr int32_t chunkSize = 32;
+constexpr int32_t mapSizeInChunks = 4;
+
+static std::atomic<uint64_t> allocationCount = 0;
+static std::atomic<uint64_t> allocatedBytes = 0;
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr) throw std::bad_alloc();
+
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// Keeps results alive so the compiler can't optimize the benchmarked work away.
+static volatile int64_t sink = 0;
+
+struct BenchResult {
+    double minMs;
+    double medianMs;
+    uint64_t allocations;
+    uint64_t bytes;
+};
+
+// Run task once to warm up, then time it for the given number of iterations. Tasks that change
+// their own input can pass reset, which runs untimed before each iteration.
+BenchResult runBench(int32_t iterations, const std::function<void()>& task, const std::function<void()>& reset = nullptr) {
+    task();
+
+    std::vector<double> times;
+    times.reserve(iterations);
+
+    uint64_t taskAllocationCount = 0;
+    uint64_t taskAllocatedBytes = 0;
+
+    for (int32_t i = 0; i < iterations; i++) {
+        if (reset) reset();
+
+        uint64_t startAllocationCount = allocationCount;
+        uint64_t startAllocatedBytes = allocatedBytes;
+        auto startTime = std::chrono::steady_clock::now();
+        task();
+        auto endTime = std::chrono::steady_clock::now();
+        taskAllocationCount += allocationCount - startAllocationCount;
+        taskAllocatedBytes += allocatedBytes - startAllocatedBytes;
+        times.push_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+    }
+
+    std::sort(times.begin(), times.end());
+
+    return BenchResult{
+        times[0],
+        times[times.size() / 2],
+        taskAllocationCount / iterations,
+        taskAllocatedBytes / iterations,
+    };
+}
+
+void printResult(const std::string& name, BenchResult result, double items, const std::string& itemName) {
+    double itemsPerSecond = items / (result.medianMs / 1000.0);
+
+    std::printf("%-24s %10.3f ms %10.3f ms %14.0f %-10s %10" PRIu64 " %12" PRIu64 "\n", name.c_str(), result.medianMs,
+        result.minMs, itemsPerSecond, (itemName + "/s").c_str(), result.allocations, result.bytes);
+}
+
+void generateWorld(World& world, ThreadPool& threadPool) {
+    siv::BasicPerlinNoise<float> noise{seed};
+    WorldGenerator worldGenerator(world, threadPool);
+    worldGenerator.start(noise, TerrainSettings{}, 0, 0);
+    worldGenerator.wait();
+}
+
+// Random points inside of the world, the same ones every run.
+std::vector<glm::vec3> getRandomPositions(size_t count, float mapSize) {
+    std::mt19937 rng{seed};
+    std::uniform_real_distribution<float> distribution(0.0f, mapSize);
+    std::vector<glm::vec3> positions(count);
+
+    for (glm::vec3& position : positions) {
+        position = glm::vec3(distribution(rng), distribution(rng), distribution(rng));
+    }
+
+    return positions;
+}
+
+std::vector<glm::vec3> getRandomDirections(size_t count) {
+    std::mt19937 rng{seed + 1};
+    std::normal_distribution<float> distribution;
+    std::vector<glm::vec3> directions(count);
+
+    for (glm::vec3& direction : directions) {
+        direction = glm::normalize(glm::vec3(distribution(rng), distribution(rng), distribution(rng)));
+    }
+
+    return directions;
+}
+
+int main() {
+    ThreadPool threadPool;
+    int32_t chunkCount = mapSizeInChunks * mapSizeInChunks * mapSizeInChunks;
+    float mapSize = static_cast<float>(chunkSize * mapSizeInChunks);
+
+    std::printf("%d chunks of %d^3 blocks, %zu threads\n\n", chunkCount, chunkSize, threadPool.getThreadCount());
+    std::printf("%-24s %13s %13s %25s %10s %12s\n", "benchmark", "median", "min", "throughput", "allocs/it", "bytes/it");
+
+    // Generating from scratch, including lighting and meshing.
+    BenchResult generateResult = runBench(3, [&]() {
+        World world(chunkSize, mapSizeInChunks);
+        generateWorld(world, threadPool);
+        sink = sink + static_cast<int64_t>(world.getBlock(0, 0, 0));
+    });
+    printResult("World generation", generateResult, chunkCount, "chunks");
+
+    World world(chunkSize, mapSizeInChunks);
+    generateWorld(world, threadPool);
+
+    BenchResult meshResult = runBench(5, [&]() {
+        for (int32_t z = 0; z < mapSizeInChunks; z++) {
+            for (int32_t y = 0; y < mapSizeInChunks; y++) {
+                for (int32_t x = 0; x < mapSizeInChunks; x++) {
+                    world.getChunk(x, y, z).updateMesh(world);
+                }
+            }
+        }
+    });
+    printResult("Chunk::updateMesh", meshResult, chunkCount, "chunks");
+
+    ChunkCodec chunkCodec(chunkSize);
+    std::vector<uint8_t> encodedChunks;
+    std::vector<size_t> encodedChunkEnds;
+
+    BenchResult encodeResult = runBench(10, [&]() {
+        encodedChunks.clear();
+        encodedChunkEnds.clear();
+
+        for (int32_t i = 0; i < chunkCount; i++) {
+            glm::ivec3 chunkPos = indexTo3d(i, mapSizeInChunks);
+            chunkCodec.encode(world.getChunk(chunkPos.x, chunkPos.y, chunkPos.z).getBlockData(), encodedChunks);
+            encodedChunkEnds.push_back(encodedChunks.size());
+        }
+    });
+    printResult("ChunkCodec::encode", encodeResult, chunkCount, "chunks");
+
+    std::vector<Blocks> decodedBlocks(chunkSize * chunkSize * chunkSize);
+
+    BenchResult decodeResult = runBench(10, [&]() {
+        size_t start = 0;
+
+        for (size_t end : encodedChunkEnds) {
+            sink = sink + chunkCodec.decode(encodedChunks.data() + start, end - start, decodedBlocks.data());
+            start = end;
+        }
+    });
+    printResult("ChunkCodec::decode", decodeResult, chunkCount, "chunks");
+
+    // Make sure the timed codec is still lossless, outside of the timing.
+    size_t decodeStart = 0;
+
+    for (int32_t i = 0; i < chunkCount; i++) {
+        glm::ivec3 chunkPos = indexTo3d(i, mapSizeInChunks);
+        const Blocks* chunkBlocks = world.getChunk(chunkPos.x, chunkPos.y, chunkPos.z).getBlockData();
+        size_t decodeEnd = encodedChunkEnds[i];
+
+        if (!chunkCodec.decode(encodedChunks.data() + decodeStart, decodeEnd - decodeStart, decodedBlocks.data()) ||
+            !std::equal(decodedBlocks.begin(), decodedBlocks.end(), chunkBlocks)) {
+            std::fprintf(stderr, "Chunk %d %d %d didn't round trip through ChunkCodec\n", chunkPos.x, chunkPos.y, chunkPos.z);
+            return 1;
+        }
+
+        decodeStart = decodeEnd;
+    }
+
+    size_t rawChunkBytes = static_cast<size_t>(chunkCount) * chunkSize * chunkSize * chunkSize;
+    std::printf("%-24s %10zu bytes, %.1f%% of raw\n", "encoded chunks", encodedChunks.size(),
+        100.0 * static_cast<double>(encodedChunks.size()) / static_cast<double>(rawChunkBytes));
+
+    constexpr size_t blockQueryCount = 1 << 20;
+    std::vector<glm::vec3> blockPositions = getRandomPositions(blockQueryCount, mapSize);
+    std::vector<glm::ivec3> blockQueries(blockQueryCount);
+
+    for (size_t i = 0; i < blockQueryCount; i++) {
+        blockQueries[i] = glm::ivec3(blockPositions[i]);
+    }
+
+    BenchResult getBlockResult = runBench(10, [&]() {
+        int64_t occupiedCount = 0;
+
+        for (glm::ivec3 query : blockQueries) {
+            occupiedCount += world.getBlock(query.x, query.y, query.z) != Blocks::Air;
+        }
+
+        sink = sink + occupiedCount;
+    });
+    printResult("World::getBlock", getBlockResult, blockQueryCount, "queries");
+
+    constexpr size_t rayCount = 1 << 16;
+    constexpr float rayRange = 10.0f;
+    std::vector<glm::vec3> rayStarts = getRandomPositions(rayCount, mapSize);
+    std::vector<glm::vec3> rayDirections = getRandomDirections(rayCount);
+
+    BenchResult raycastResult = runBench(10, [&]() {
+        int64_t hitCount = 0;
+
+        for (size_t i = 0; i < rayCount; i++) {
+            hitCount += raycast(world, rayStarts[i], rayDirections[i], rayRange).hit;
+        }
+
+        sink = sink + hitCount;
+    });
+    printResult("raycast", raycastResult, rayCount, "rays");
+
+    std::vector<Ray> rays(rayCount);
+    std::vector<RaycastHit> rayHits;
+
+    for (size_t i = 0; i < rayCount; i++) {
+        rays[i] = Ray{rayStarts[i], rayDirections[i], rayRange};
+    }
+
+    BenchResult raycastBatchResult = runBench(10, [&]() {
+        raycastBatch(world, rays, rayHits);
+        int64_t hitCount = 0;
+
+        for (const RaycastHit& hit : rayHits) {
+            hitCount += hit.hit;
+        }
+
+        sink = sink + hitCount;
+    });
+    printResult("raycastBatch", raycastBatchResult, rayCount, "rays");
+
+    // Long rays spend most of their time in empty space.
+    constexpr float longRayRange = 100.0f;
+
+    for (Ray& ray : rays) {
+        ray.range = longRayRange;
+    }
+
+    BenchResult longRaycastResult = runBench(10, [&]() {
+        raycastBatch(world, rays, rayHits);
+        int64_t hitCount = 0;
+
+        for (const RaycastHit& hit : rayHits) {
+            hitCount += hit.hit;
+        }
+
+        sink = sink + hitCount;
+    });
+    printResult("raycastBatch (long)", longRaycastResult, rayCount, "rays");
+
+    constexpr size_t collisionCount = 1 << 18;
+    const glm::vec3 playerSize(0.8f, 2.8f, 0.8f);
+    std::vector<glm::vec3> collisionPositions = getRandomPositions(collisionCount, mapSize);
+
+    BenchResult collisionResult = runBench(10, [&]() {
+        int64_t collisionHitCount = 0;
+
+        for (glm::vec3 position : collisionPositions) {
+            collisionHitCount += getBlockCollision(world, position, playerSize).has_value();
+        }
+
+        sink = sink + collisionHitCount;
+    });
+    printResult("getBlockCollision", collisionResult, collisionCount, "queries");
+
+    std::vector<glm::vec3> sweepMotions = getRandomDirections(collisionCount);
+
+    BenchResult sweepResult = runBench(10, [&]() {
+        int64_t sweepHitCount = 0;
+
+        for (size_t i = 0; i < collisionCount; i++) {
+            sweepHitCount += sweepBox(world, collisionPositions[i], playerSize, sweepMotions[i]).hit;
+        }
+
+        sink = sink + sweepHitCount;
+    });
+    printResult("sweepBox", sweepResult, collisionCount, "queries");
+
+    // Mobs and dropped items scattered through the world, each iteration is one simulation tick.
+    constexpr size_t entityCount = 1 << 12;
+    constexpr float entityTimeStep = 1.0f / 60.0f;
+    const glm::vec3 mobSize(0.8f, 1.8f, 0.8f);
+    const glm::vec3 itemSize(0.25f);
+    std::vector<glm::vec3> entityPositions = getRandomPositions(entityCount, mapSize);
+    std::vector<glm::vec3> entityDirections = getRandomDirections(entityCount);
+    EntityStore entities;
+    EntityPhysics entityPhysics(mobSize.y, threadPool);
+
+    for (size_t i = 0; i < entityCount; i++) {
+        EntityId id = entities.create(entityPositions[i], i % 2 == 0 ? mobSize : itemSize);
+        entities.getVelocities()[entities.getIndex(id)] = entityDirections[i] * 4.0f;
+    }
+
+    BenchResult entityResult = runBench(60, [&]() {
+        entityPhysics.update(entities, world, entityTimeStep);
+        sink = sink + static_cast<int64_t>(entities.getPositions()[0].y);
+    });
+    printResult("EntityPhysics::update", entityResult, entityCount, "entities");
+
+    // Cull a much larger grid of chunks than the benchmark world has, from a camera inside of it.
+    constexpr int32_t cullingGridSize = 64;
+    constexpr int32_t cullingChunkCount = cullingGridSize * cullingGridSize * cullingGridSize;
+    const glm::vec3 chunkExtent(static_cast<float>(chunkSize));
+    const glm::vec3 cameraPos(cullingGridSize * chunkSize * 0.5f);
+
+    glm::mat4 view = glm::lookAt(cameraPos, cameraPos + glm::vec3(1.0f, -0.3f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 proj = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    Frustum frustum;
+
+    BenchResult cullingResult = runBench(10, [&]() {
+        frustum.calculate(proj * view);
+        int64_t visibleCount = 0;
+
+        for (int32_t z = 0; z < cullingGridSize; z++) {
+            for (int32_t y = 0; y < cullingGridSize; y++) {
+                for (int32_t x = 0; x < cullingGridSize; x++) {
+                    glm::vec3 chunkPos = glm::vec3(x, y, z) * chunkExtent;
+                    visibleCount += !frustum.shouldBeCulled(chunkPos, chunkExtent);
+                }
+            }
+        }
+
+        sink = sink + visibleCount;
+    });
+    printResult("Frustum culling", cullingResult, cullingChunkCount, "chunks");
+
+    // An explosion clearing a sphere in the middle of the world, it spans several chunks. This edits the
+    // world, so it runs last.
+    constexpr int32_t explosionRadius = 6;
+    const glm::ivec3 explosionCenter(static_cast<int32_t>(mapSize * 0.5f) - 3);
+    std::vector<BlockEdit> explosionEdits;
+    // Puts back the blocks that the explosion cleared, so every timed explosion has blocks to clear.
+    std::vector<BlockEdit> refillEdits;
+
+    for (int32_t z = -explosionRadius; z <= explosionRadius; z++) {
+        for (int32_t y = -explosionRadius; y <= explosionRadius; y++) {
+            for (int32_t x = -explosionRadius; x <= explosionRadius; x++) {
+                if (x * x + y * y + z * z > explosionRadius * explosionRadius) continue;
+
+                glm::ivec3 pos = explosionCenter + glm::ivec3(x, y, z);
+                explosionEdits.push_back(BlockEdit{pos.x, pos.y, pos.z, Blocks::Air});
+                refillEdits.push_back(BlockEdit{pos.x, pos.y, pos.z, world.getBlock(pos.x, pos.y, pos.z)});
+            }
+        }
+    }
+
+    EditLog editLog(chunkSize, mapSizeInChunks);
+    PacketWriter batchWriter;
+    std::vector<BlockEdit> readEdits;
+    size_t batchCount = 0;
+
+    BenchResult editLogResult = runBench(10, [&]() {
+        for (const BlockEdit& edit : explosionEdits) {
+            editLog.record(edit.x, edit.y, edit.z, edit.block);
+        }
+
+        batchWriter.clear();
+        batchCount = editLog.getEditedChunks().size();
+
+        for (glm::ivec3 chunkPos : editLog.getEditedChunks()) {
+            editLog.writeBatch(chunkPos, 0, batchWriter);
+        }
+
+        editLog.clear();
+
+        PacketReader reader(batchWriter.getData().data(), batchWriter.getData().size());
+        uint8_t type;
+        uint32_t version;
+        glm::ivec3 chunkPos;
+
+        while (reader.readU8(type) && editLog.readBatch(reader, version, chunkPos, readEdits)) {
+            sink = sink + static_cast<int64_t>(readEdits.size());
+        }
+    });
+    printResult("EditLog batches", editLogResult, static_cast<double>(explosionEdits.size()), "edits");
+    std::printf("%-24s %10zu edits in %zu batches, %zu bytes\n", "explosion", explosionEdits.size(), batchCount,
+        batchWriter.getData().size());
+
+    BenchResult setBlocksResult = runBench(3, [&]() {
+        world.setBlocks(explosionEdits);
+    }, [&]() {
+        world.setBlocks(refillEdits);
+    });
+    printResult("World::setBlocks", setBlocksResult, static_cast<double>(explosionEdits.size()), "edits");
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "chunkPacketCache.hpp"
+
+#include "../src/stats.hpp"
+#include "../src/profiler.hpp"
+
+ChunkPacketCache::ChunkPacketCache(World& world)
+    : world(world), mapSizeInChunks(world.getMapSizeInChunks()), chunkCodec(world.getChunkSize()) {
+    entries.resize(mapSizeInChunks * mapSizeInChunks * mapSizeInChunks);
+}
+
+ChunkPacketCache::~ChunkPacketCache() {
+    for (Entry& entry : entries) {
+        releasePacket(entry);
+    }
+}
+
+ENetPacket* ChunkPacketCache::getPacket(int32_t chunkX, int32_t chunkY, int32_t chunkZ) {
+    Chunk& chunk = world.getChunk(chunkX, chunkY, chunkZ);
+    Entry& entry = entries[chunkX + chunkY * mapSizeInChunks + chunkZ * mapSizeInChunks * mapSizeInChunks];
+
+    if (entry.packet && entry.version == chunk.getVersion()) return entry.packet;
+
+    PROFILE_ZONE("ChunkPacketCache::encode");
+
+    releasePacket(entry);
+
+    encodedChunk.clear();
+    chunkCodec.encode(chunk.getBlockData(), encodedChunk);
+
+    packetWriter.clear();
+    packetWriter.writeU8(static_cast<uint8_t>(MessageType::ChunkData));
+    packetWriter.writeI32(chunkX);
+    packetWriter.writeI32(chunkY);
+    packetWriter.writeI32(chunkZ);
+    packetWriter.writeU32(chunk.getVersion());
+    packetWriter.writeBytes(encodedChunk.data(), encodedChunk.size());
+
+    const std::vector<uint8_t>& data = packetWriter.getData();
+    entry.packet = enet_packet_create(data.data(), data.size(), ENET_PACKET_FLAG_RELIABLE);
+    entry.version = chunk.getVersion();
+    // The cache's own reference, enet destroys packets once their reference count drops back to zero.
+    entry.packet->referenceCount++;
+
+    addCounter(Counter::ChunksEncoded);
+
+    return entry.packet;
+}
+
+void ChunkPacketCache::releasePacket(Entry& entry) {
+    if (!entry.packet) return;
+
+    entry.packet->referenceCount--;
+
+    if (entry.packet->referenceCount == 0) {
+        enet_packet_destroy(entry.packet);
+    }
+
+    entry.packet = nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include "../deps/enet.h"
+
+#include "../src/world.hpp"
+#include "../src/chunkCodec.hpp"
+#include "../src/protocol.hpp"
+
+// Keeps the encoded ChunkData packet for each chunk, so a chunk is encoded once per change instead of once
+// per client that it's sent to. The cache holds a reference to each packet and enet holds one for every
+// send that's still queued, so a replaced packet lives until the last client has been sent it.
+class ChunkPacketCache {
+public:
+    ChunkPacketCache(World& world);
+    ~ChunkPacketCache();
+    // Get the packet for the chunk as it is now, it can be passed to enet_peer_send any number of times.
+    ENetPacket* getPacket(int32_t chunkX, int32_t chunkY, int32_t chunkZ);
+
+private:
+    struct Entry {
+        ENetPacket* packet = nullptr;
+        // The chunk version that the packet was encoded from.
+        uint32_t version = 0;
+    };
+
+    void releasePacket(Entry& entry);
+
+    World& world;
+    int32_t mapSizeInChunks;
+    ChunkCodec chunkCodec;
+    std::vector<Entry> entries;
+    PacketWriter packetWriter;
+    std::vector<uint8_t> encodedChunk;
+};
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "interestManager.hpp"
+
+#include <algorithm>
+
+InterestManager::InterestManager(int32_t mapSizeInChunks, int32_t viewDistance)
+    : mapSizeInChunks(mapSizeInChunks), viewDistance(viewDistance) {
+    chunkWatchers.resize(mapSizeInChunks * mapSizeInChunks * mapSizeInChunks);
+}
+
+void InterestManager::addClient(ClientId client, glm::ivec3 chunkPos, std::vector<glm::ivec3>& entered) {
+    clientChunks[client] = chunkPos;
+
+    // Nothing is in view yet, so the difference is the whole view.
+    ChunkBox nothing{glm::ivec3(0), glm::ivec3(0)};
+    size_t firstEntered = entered.size();
+    addBoxDifference(getViewBox(chunkPos), nothing, entered);
+
+    for (size_t i = firstEntered; i < entered.size(); i++) {
+        addWatcher(client, entered[i]);
+    }
+}
+
+void InterestManager::removeClient(ClientId client) {
+    auto clientChunk = clientChunks.find(client);
+    if (clientChunk == clientChunks.end()) return;
+
+    ChunkBox nothing{glm::ivec3(0), glm::ivec3(0)};
+    removedChunks.clear();
+    addBoxDifference(getViewBox(clientChunk->second), nothing, removedChunks);
+
+    for (glm::ivec3 chunkPos : removedChunks) {
+        removeWatcher(client, chunkPos);
+    }
+
+    clientChunks.erase(clientChunk);
+}
+
+void InterestManager::moveClient(ClientId client, glm::ivec3 chunkPos, std::vector<glm::ivec3>& entered, std::vector<glm::ivec3>& left) {
+    glm::ivec3& clientChunk = clientChunks[client];
+    if (clientChunk == chunkPos) return;
+
+    ChunkBox oldBox = getViewBox(clientChunk);
+    ChunkBox newBox = getViewBox(chunkPos);
+    clientChunk = chunkPos;
+
+    size_t firstEntered = entered.size();
+    size_t firstLeft = left.size();
+    addBoxDifference(newBox, oldBox, entered);
+    addBoxDifference(oldBox, newBox, left);
+
+    for (size_t i = firstEntered; i < entered.size(); i++) {
+        addWatcher(client, entered[i]);
+    }
+
+    for (size_t i = firstLeft; i < left.size(); i++) {
+        removeWatcher(client, left[i]);
+    }
+}
+
+const std::vector<ClientId>& InterestManager::getWatchers(glm::ivec3 chunkPos) {
+    return chunkWatchers[getChunkIndex(chunkPos)];
+}
+
+int32_t InterestManager::getChunkIndex(glm::ivec3 chunkPos) {
+    return chunkPos.x + chunkPos.y * mapSizeInChunks + chunkPos.z * mapSizeInChunks * mapSizeInChunks;
+}
+
+InterestManager::ChunkBox InterestManager::getViewBox(glm::ivec3 chunkPos) {
+    ChunkBox box;
+
+    for (int32_t axis = 0; axis < 3; axis++) {
+        box.min[axis] = std::clamp(chunkPos[axis] - viewDistance, 0, mapSizeInChunks);
+        box.max[axis] = std::clamp(chunkPos[axis] + viewDistance + 1, 0, mapSizeInChunks);
+    }
+
+    return box;
+}
+
+// Add the chunks in a that aren't in b. Columns of a that are inside of b on x and y only
+// visit the parts of the column outside of b on z, so the work is proportional to the chunks added.
+void InterestManager::addBoxDifference(ChunkBox a, ChunkBox b, std::vector<glm::ivec3>& chunks) {
+    for (int32_t x = a.min.x; x < a.max.x; x++) {
+        bool isXInside = x >= b.min.x && x < b.max.x;
+
+        for (int32_t y = a.min.y; y < a.max.y; y++) {
+            bool isYInside = y >= b.min.y && y < b.max.y;
+
+            if (!isXInside || !isYInside) {
+                for (int32_t z = a.min.z; z < a.max.z; z++) {
+                    chunks.push_back(glm::ivec3(x, y, z));
+                }
+
+                continue;
+            }
+
+            for (int32_t z = a.min.z; z < std::min(b.min.z, a.max.z); z++) {
+                chunks.push_back(glm::ivec3(x, y, z));
+            }
+
+            for (int32_t z = std::max(b.max.z, a.min.z); z < a.max.z; z++) {
+                chunks.push_back(glm::ivec3(x, y, z));
+            }
+        }
+    }
+}
+
+void InterestManager::addWatcher(ClientId client, glm::ivec3 chunkPos) {
+    chunkWatchers[getChunkIndex(chunkPos)].push_back(client);
+}
+
+void InterestManager::removeWatcher(ClientId client, glm::ivec3 chunkPos) {
+    std::vector<ClientId>& watchers = chunkWatchers[getChunkIndex(chunkPos)];
+    auto watcher = std::find(watchers.begin(), watchers.end(), client);
+    if (watcher == watchers.end()) return;
+
+    *watcher = watchers.back();
+    watchers.pop_back();
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+using ClientId = uint32_t;
+
+// Tracks the area of interest of each client, the cube of chunks within viewDistance of the chunk they're in.
+// Moving a client only visits the chunks that enter or leave its view, and each chunk keeps a list of the
+// clients watching it, so filtering what gets sent costs as much as what actually changed.
+class InterestManager {
+public:
+    InterestManager(int32_t mapSizeInChunks, int32_t viewDistance);
+    // Fills entered with every chunk the client can see from chunkPos.
+    void addClient(ClientId client, glm::ivec3 chunkPos, std::vector<glm::ivec3>& entered);
+    void removeClient(ClientId client);
+    // Fills entered and left with the chunks that came into and went out of the client's view.
+    void moveClient(ClientId client, glm::ivec3 chunkPos, std::vector<glm::ivec3>& entered, std::vector<glm::ivec3>& left);
+    const std::vector<ClientId>& getWatchers(glm::ivec3 chunkPos);
+    int32_t getChunkIndex(glm::ivec3 chunkPos);
+
+private:
+    // Chunks from min up to but not including max, clamped to the map.
+    struct ChunkBox {
+        glm::ivec3 min;
+        glm::ivec3 max;
+    };
+
+    ChunkBox getViewBox(glm::ivec3 chunkPos);
+    void addBoxDifference(ChunkBox a, ChunkBox b, std::vector<glm::ivec3>& chunks);
+    void addWatcher(ClientId client, glm::ivec3 chunkPos);
+    void removeWatcher(ClientId client, glm::ivec3 chunkPos);
+
+    int32_t mapSizeInChunks;
+    int32_t viewDistance;
+    std::unordered_map<ClientId, glm::ivec3> clientChunks;
+    std::vector<std::vector<ClientId>> chunkWatchers;
+    std::vector<glm::ivec3> removedChunks;
+};
\ No newline at end of file
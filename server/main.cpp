@@ -0,0 +1,58 @@
+#include <csignal>
+#include <cstdlib>
+#include <string>
+#include <iostream>
+
+#include "../deps/enet.h"
+
+#include "../src/profiler.hpp"
+
+#include "server.hpp"
+
+static Server* runningServer = nullptr;
+
+static void handleSignal(int) {
+    if (runningServer) {
+        runningServer->stop();
+    }
+}
+
+// Pass --port <port> to listen somewhere other than the default port.
+int main(int argc, char** argv) {
+    uint16_t port = defaultServerPort;
+
+    if (argc == 3 && std::string(argv[1]) == "--port") {
+        port = static_cast<uint16_t>(std::atoi(argv[2]));
+    }
+
+    setProfilerThreadName("Server");
+
+    if (enet_initialize() != 0) {
+        std::cerr << "Failed to initialize enet\n";
+        return EXIT_FAILURE;
+    }
+
+    int32_t exitCode = EXIT_SUCCESS;
+
+    {
+        Server server(port);
+
+        if (server.start()) {
+            std::cout << "Listening on port " << port << "\n";
+
+            runningServer = &server;
+            std::signal(SIGINT, handleSignal);
+            std::signal(SIGTERM, handleSignal);
+
+            server.run();
+            runningServer = nullptr;
+        } else {
+            std::cerr << "Failed to listen on port " << port << "\n";
+            exitCode = EXIT_FAILURE;
+        }
+    }
+
+    enet_deinitialize();
+
+    return exitCode;
+}
\ No newline at end of file
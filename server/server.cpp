@@ -0,0 +1,462 @@
+#include "server.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <iostream>
+
+#include "../deps/perlinNoise.hpp"
+
+#include "../src/gameMath.hpp"
+#include "../src/profiler.hpp"
+
+// These match the client, so both see the same world.
+constexpr int32_t seed = 123;
+constexpr int32_t chunkSize = 32;
+constexpr int32_t mapSizeInChunks = 4;
+constexpr int32_t chunkCount = mapSizeInChunks * mapSizeInChunks * mapSizeInChunks;
+constexpr TerrainSettings terrainSettings{true, 4};
+
+constexpr uint16_t tickRate = 60;
+constexpr float simulationTimeStep = 1.0f / tickRate;
+// When the server falls further behind than this it slows down instead of running a burst of ticks to catch up.
+constexpr float maxTickBacklog = 0.25f;
+
+constexpr size_t maxClients = 32;
+// Chunks are sent a few at a time so joining doesn't flood the connection or hold up other messages.
+constexpr size_t chunksPerTick = 2;
+// How many chunks away from the player's chunk are sent, a little past the client's fog.
+constexpr int32_t viewDistance = 3;
+
+const glm::vec3 playerSize(0.8f, 2.8f, 0.8f);
+constexpr float playerSpeed = 5.0f;
+constexpr float playerJumpForce = 9.0f;
+// A little further than the client's reach, to allow for latency.
+constexpr float maxEditDistance = 12.0f;
+
+constexpr float statsInterval = 5.0f;
+constexpr const char* statsPath = "";
+
+Server::Server(uint16_t port)
+    : port(port), world(chunkSize, mapSizeInChunks), worldGenerator(world, threadPool),
+      entityPhysics(playerSize.y, threadPool), statsReporter(statsInterval, statsPath), chunkPacketCache(world),
+      interestManager(mapSizeInChunks, viewDistance), editLog(chunkSize, mapSizeInChunks) {}
+
+Server::~Server() {
+    if (host) {
+        enet_host_destroy(host);
+    }
+}
+
+bool Server::start() {
+    std::mt19937 rng{seed};
+    siv::BasicPerlinNoise<float> noise{seed};
+
+    glm::ivec3 spawnChunk = indexTo3d(rng() % chunkCount, mapSizeInChunks);
+
+    // The whole world is generated up front, so the simulation never reads chunks that are still being generated.
+    auto startTime = std::chrono::steady_clock::now();
+    worldGenerator.start(noise, terrainSettings, spawnChunk.x, spawnChunk.z);
+    worldGenerator.wait();
+    std::chrono::duration<float> generationTime = std::chrono::steady_clock::now() - startTime;
+    std::cout << "Generated the world in " << generationTime.count() * 1000.0f << "ms\n";
+
+    // Spawn with the player's feet at the bottom of the open block.
+    spawnPos = world.getSpawnPos(spawnChunk.x, spawnChunk.y, spawnChunk.z, true).value();
+    spawnPos.y += playerSize.y * 0.5f - 0.5f;
+
+    ENetAddress address{};
+    address.host = ENET_HOST_ANY;
+    address.port = port;
+
+    host = enet_host_create(&address, maxClients, static_cast<size_t>(Channel::Count), 0, 0);
+    if (!host) return false;
+
+    isRunning = true;
+
+    return true;
+}
+
+void Server::run() {
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(simulationTimeStep));
+    const Clock::duration maxBacklog = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(maxTickBacklog));
+    Clock::time_point startTime = Clock::now();
+    Clock::time_point nextTickTime = startTime;
+
+    while (isRunning) {
+        Clock::time_point now = Clock::now();
+
+        if (now >= nextTickTime) {
+            if (now - nextTickTime > maxBacklog) {
+                nextTickTime = now;
+            }
+
+            tick();
+            nextTickTime += tickDuration;
+            statsReporter.update(std::chrono::duration<float>(now - startTime).count());
+
+            continue;
+        }
+
+        // Wait for network events until the next tick is due.
+        auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(nextTickTime - now).count();
+        ENetEvent event;
+        int32_t result = enet_host_service(host, &event, static_cast<enet_uint32>(timeout));
+
+        if (result > 0) {
+            handleEvent(event);
+        } else if (result < 0) {
+            std::cerr << "Failed to receive network events\n";
+        }
+    }
+
+    for (auto& [entity, client] : clients) {
+        enet_peer_disconnect(client.peer, 0);
+    }
+
+    enet_host_flush(host);
+}
+
+void Server::stop() {
+    isRunning = false;
+}
+
+void Server::handleEvent(ENetEvent& event) {
+    switch (event.type) {
+    case ENET_EVENT_TYPE_CONNECT:
+        connectClient(event.peer, event.data);
+        break;
+    case ENET_EVENT_TYPE_RECEIVE: {
+        Client* client = static_cast<Client*>(event.peer->data);
+
+        if (client) {
+            receiveMessage(*client, event.packet->data, event.packet->dataLength);
+        }
+
+        enet_packet_destroy(event.packet);
+        break;
+    }
+    case ENET_EVENT_TYPE_DISCONNECT:
+    case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
+        disconnectClient(event.peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+        break;
+    }
+}
+
+void Server::connectClient(ENetPeer* peer, uint32_t clientVersion) {
+    if (clientVersion != protocolVersion) {
+        std::cout << "Rejected a client with protocol version " << clientVersion << "\n";
+        enet_peer_disconnect(peer, 0);
+        return;
+    }
+
+    EntityId entity = entities.create(spawnPos, playerSize);
+    Client& client = clients[entity];
+    client.peer = peer;
+    client.entity = entity;
+    client.chunkPos = getChunkPos(spawnPos);
+    client.chunkStates.assign(chunkCount, ChunkState::Hidden);
+    peer->data = &client;
+
+    enteredChunks.clear();
+    interestManager.addClient(entity, client.chunkPos, enteredChunks);
+    queueChunks(client, enteredChunks);
+
+    packetWriter.clear();
+    packetWriter.writeU8(static_cast<uint8_t>(MessageType::Welcome));
+    packetWriter.writeU32(protocolVersion);
+    packetWriter.writeU32(client.entity);
+    packetWriter.writeI32(chunkSize);
+    packetWriter.writeI32(mapSizeInChunks);
+    packetWriter.writeU16(tickRate);
+    send(peer, Channel::Reliable, packetWriter);
+
+    std::cout << "Client " << client.entity << " connected, " << clients.size() << " online\n";
+}
+
+void Server::disconnectClient(ENetPeer* peer) {
+    Client* client = static_cast<Client*>(peer->data);
+    if (!client) return;
+
+    EntityId entity = client->entity;
+    interestManager.removeClient(entity);
+    entities.destroy(entity);
+    clients.erase(entity);
+    peer->data = nullptr;
+
+    std::cout << "Client " << entity << " disconnected, " << clients.size() << " online\n";
+}
+
+// Messages that don't parse are dropped.
+void Server::receiveMessage(Client& client, const uint8_t* data, size_t size) {
+    PacketReader reader(data, size);
+    uint8_t type;
+    if (!reader.readU8(type)) return;
+
+    switch (static_cast<MessageType>(type)) {
+    case MessageType::Movement:
+        receiveMovement(client, reader);
+        break;
+    case MessageType::EditBlock:
+        receiveEditBlock(client, reader);
+        break;
+    default:
+        break;
+    }
+}
+
+void Server::receiveMovement(Client& client, PacketReader& reader) {
+    uint32_t clientTick;
+    glm::vec2 moveDir;
+    uint8_t wantsToJump;
+
+    if (!reader.readU32(clientTick) || !reader.readFloat(moveDir.x) || !reader.readFloat(moveDir.y) || !reader.readU8(wantsToJump)) return;
+    if (!std::isfinite(moveDir.x) || !std::isfinite(moveDir.y)) return;
+
+    // Movement isn't sent reliably, so it can arrive out of order. Ticks are compared so that they can wrap around.
+    if (client.hasMovement && static_cast<int32_t>(clientTick - client.movementTick) <= 0) return;
+
+    client.movementTick = clientTick;
+    client.hasMovement = true;
+
+    float moveLength = glm::length(moveDir);
+
+    if (moveLength > 1.0f) {
+        moveDir /= moveLength;
+    }
+
+    client.moveDir = moveDir;
+    client.wantsToJump = wantsToJump != 0;
+}
+
+void Server::receiveEditBlock(Client& client, PacketReader& reader) {
+    int32_t x, y, z;
+    uint8_t block;
+
+    if (!reader.readI32(x) || !reader.readI32(y) || !reader.readI32(z) || !reader.readU8(block)) return;
+    if (block >= blockTypeCount) return;
+
+    int32_t mapSize = world.getMapSize();
+    if (x < 0 || x >= mapSize || y < 0 || y >= mapSize || z < 0 || z >= mapSize) return;
+
+    glm::vec3 playerPos = entities.getPositions()[entities.getIndex(client.entity)];
+    glm::vec3 blockCenter = glm::vec3(x, y, z) + glm::vec3(0.5f);
+    if (glm::distance(playerPos, blockCenter) > maxEditDistance) return;
+
+    Blocks newBlock = static_cast<Blocks>(block);
+    if (world.getBlock(x, y, z) == newBlock) return;
+
+    world.setBlock(x, y, z, newBlock);
+    editLog.record(x, y, z, newBlock);
+}
+
+void Server::tick() {
+    PROFILE_ZONE("Server::tick");
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    applyMovement();
+    entityPhysics.update(entities, world, simulationTimeStep);
+    updateInterest();
+
+    for (auto& [entity, client] : clients) {
+        streamChunks(client);
+    }
+
+    sendEdits();
+    sendEntityPositions();
+    enet_host_flush(host);
+    simulationTick++;
+
+    std::chrono::duration<float, std::milli> tickTime = std::chrono::steady_clock::now() - startTime;
+    recordHistogram(Histogram::TickTime, tickTime.count());
+}
+
+void Server::applyMovement() {
+    std::vector<glm::vec3>& velocities = entities.getVelocities();
+    std::vector<uint8_t>& groundedFlags = entities.getGroundedFlags();
+
+    for (auto& [entity, client] : clients) {
+        uint32_t index = entities.getIndex(entity);
+        glm::vec3& velocity = velocities[index];
+        velocity.x = client.moveDir.x * playerSpeed;
+        velocity.z = client.moveDir.y * playerSpeed;
+
+        if (client.wantsToJump && groundedFlags[index]) {
+            velocity.y = playerJumpForce;
+        }
+    }
+}
+
+// Only clients that moved into another chunk have anything to update.
+void Server::updateInterest() {
+    PROFILE_ZONE("Server::updateInterest");
+
+    std::vector<glm::vec3>& positions = entities.getPositions();
+
+    for (auto& [entity, client] : clients) {
+        glm::ivec3 chunkPos = getChunkPos(positions[entities.getIndex(entity)]);
+        if (chunkPos == client.chunkPos) continue;
+
+        client.chunkPos = chunkPos;
+        enteredChunks.clear();
+        leftChunks.clear();
+        interestManager.moveClient(entity, chunkPos, enteredChunks, leftChunks);
+
+        for (glm::ivec3 leftChunk : leftChunks) {
+            ChunkState& state = client.chunkStates[interestManager.getChunkIndex(leftChunk)];
+
+            if (state == ChunkState::Sent) {
+                packetWriter.clear();
+                packetWriter.writeU8(static_cast<uint8_t>(MessageType::UnloadChunk));
+                packetWriter.writeI32(leftChunk.x);
+                packetWriter.writeI32(leftChunk.y);
+                packetWriter.writeI32(leftChunk.z);
+                send(client.peer, Channel::Reliable, packetWriter);
+            }
+
+            state = ChunkState::Hidden;
+        }
+
+        queueChunks(client, enteredChunks);
+    }
+}
+
+void Server::queueChunks(Client& client, const std::vector<glm::ivec3>& chunks) {
+    for (glm::ivec3 chunkPos : chunks) {
+        ChunkState& state = client.chunkStates[interestManager.getChunkIndex(chunkPos)];
+
+        if (state == ChunkState::Hidden) {
+            state = ChunkState::Queued;
+            client.queuedChunks.push_back(chunkPos);
+        }
+    }
+
+    // Furthest first, so the closest chunks can be popped off the back.
+    glm::ivec3 center = client.chunkPos;
+    std::sort(client.queuedChunks.begin(), client.queuedChunks.end(), [&](glm::ivec3 a, glm::ivec3 b) {
+        glm::ivec3 aDistance = a - center;
+        glm::ivec3 bDistance = b - center;
+        return glm::dot(aDistance, aDistance) > glm::dot(bDistance, bDistance);
+    });
+}
+
+void Server::streamChunks(Client& client) {
+    PROFILE_ZONE("Server::streamChunks");
+
+    size_t sentCount = 0;
+
+    while (sentCount < chunksPerTick && !client.queuedChunks.empty()) {
+        glm::ivec3 chunkPos = client.queuedChunks.back();
+        client.queuedChunks.pop_back();
+
+        ChunkState& state = client.chunkStates[interestManager.getChunkIndex(chunkPos)];
+        if (state != ChunkState::Queued) continue;
+
+        // Every client that's sent this chunk shares the same packet.
+        ENetPacket* packet = chunkPacketCache.getPacket(chunkPos.x, chunkPos.y, chunkPos.z);
+
+        // The peer is going away or the packet can't be sent at all, retrying would only fail again.
+        if (!sendPacket(client.peer, Channel::Reliable, packet)) {
+            state = ChunkState::Hidden;
+            return;
+        }
+
+        state = ChunkState::Sent;
+        sentCount++;
+    }
+}
+
+// Clients apply each batch at once, so a chunk is remeshed once per tick however many edits it had.
+void Server::sendEdits() {
+    PROFILE_ZONE("Server::sendEdits");
+
+    for (glm::ivec3 chunkPos : editLog.getEditedChunks()) {
+        Chunk& chunk = world.getChunk(chunkPos.x, chunkPos.y, chunkPos.z);
+
+        packetWriter.clear();
+        editLog.writeBatch(chunkPos, chunk.getVersion(), packetWriter);
+        sendToWatchers(chunkPos, Channel::Reliable, packetWriter);
+    }
+
+    editLog.clear();
+}
+
+void Server::sendEntityPositions() {
+    if (clients.empty()) return;
+
+    std::vector<EntityId>& ids = entities.getIds();
+    std::vector<glm::vec3>& positions = entities.getPositions();
+
+    packetWriter.clear();
+    packetWriter.writeU8(static_cast<uint8_t>(MessageType::EntityPositions));
+    packetWriter.writeU32(simulationTick);
+    packetWriter.writeU32(static_cast<uint32_t>(entities.getCount()));
+
+    for (size_t i = 0; i < entities.getCount(); i++) {
+        packetWriter.writeU32(ids[i]);
+        packetWriter.writeVec3(positions[i]);
+    }
+
+    broadcast(Channel::Movement, packetWriter);
+}
+
+static enet_uint32 getPacketFlags(Channel channel) {
+    return channel == Channel::Reliable ? ENET_PACKET_FLAG_RELIABLE : 0;
+}
+
+void Server::send(ENetPeer* peer, Channel channel, const PacketWriter& writer) {
+    const std::vector<uint8_t>& data = writer.getData();
+    ENetPacket* packet = enet_packet_create(data.data(), data.size(), getPacketFlags(channel));
+
+    // enet only takes a reference to packets it queued.
+    if (!sendPacket(peer, channel, packet) && packet->referenceCount == 0) {
+        enet_packet_destroy(packet);
+    }
+}
+
+// Returns false if enet didn't queue the packet, the caller still owns it then.
+bool Server::sendPacket(ENetPeer* peer, Channel channel, ENetPacket* packet) {
+    if (enet_peer_send(peer, static_cast<enet_uint8>(channel), packet) != 0) return false;
+
+    addCounter(Counter::PacketsSent);
+    addCounter(Counter::BytesSent, static_cast<int64_t>(packet->dataLength));
+
+    return true;
+}
+
+// Only clients that have been welcomed are sent to, not every connected peer.
+void Server::broadcast(Channel channel, const PacketWriter& writer) {
+    for (auto& [entity, client] : clients) {
+        send(client.peer, channel, writer);
+    }
+}
+
+// Send to the clients that have been sent the chunk, they all share one packet.
+void Server::sendToWatchers(glm::ivec3 chunkPos, Channel channel, const PacketWriter& writer) {
+    const std::vector<uint8_t>& data = writer.getData();
+    ENetPacket* packet = enet_packet_create(data.data(), data.size(), getPacketFlags(channel));
+    size_t chunkIndex = interestManager.getChunkIndex(chunkPos);
+
+    for (ClientId watcher : interestManager.getWatchers(chunkPos)) {
+        Client& client = clients.at(watcher);
+
+        if (client.chunkStates[chunkIndex] == ChunkState::Sent) {
+            sendPacket(client.peer, channel, packet);
+        }
+    }
+
+    // Nobody took a reference to the packet.
+    if (packet->referenceCount == 0) {
+        enet_packet_destroy(packet);
+    }
+}
+
+glm::ivec3 Server::getChunkPos(glm::vec3 pos) {
+    return floorToInt(pos / static_cast<float>(chunkSize));
+}
\ No newline at end of file
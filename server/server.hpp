@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+
+#include <glm/glm.hpp>
+
+#include "../deps/enet.h"
+
+#include "../src/world.hpp"
+#include "../src/worldGenerator.hpp"
+#include "../src/threadPool.hpp"
+#include "../src/entities.hpp"
+#include "../src/entityPhysics.hpp"
+#include "../src/protocol.hpp"
+#include "../src/stats.hpp"
+#include "../src/editLog.hpp"
+
+#include "chunkPacketCache.hpp"
+#include "interestManager.hpp"
+
+enum class ChunkState : uint8_t {
+    Hidden,
+    Queued,
+    Sent,
+};
+
+// A connected player. Their movement is simulated as an entity, the client only says where it wants to go.
+struct Client {
+    ENetPeer* peer;
+    EntityId entity;
+    // The chunk the player's area of interest is centered on.
+    glm::ivec3 chunkPos;
+    // Whether each chunk has been sent to the client, indexed by InterestManager::getChunkIndex.
+    std::vector<ChunkState> chunkStates;
+    // Chunks waiting to be sent, the closest ones are at the back. Chunks that left the client's
+    // view while they were waiting are skipped when they come up.
+    std::vector<glm::ivec3> queuedChunks;
+    // The latest movement the client asked for, the direction is at most one block long.
+    glm::vec2 moveDir{0.0f};
+    bool wantsToJump = false;
+    // The client tick of the latest movement, older movement that arrives late is dropped.
+    uint32_t movementTick = 0;
+    bool hasMovement = false;
+};
+
+// Owns the authoritative world and runs the simulation at a fixed tick rate. Clients are sent the chunks
+// around them as they move, then they send movement and block edits back. Edits are only sent to clients
+// that have been sent the chunk they're in, batched per chunk and tick.
+class Server {
+public:
+    Server(uint16_t port);
+    ~Server();
+    // Generate the world and start listening, returns false if the port couldn't be opened.
+    bool start();
+    // Run ticks until stop is called.
+    void run();
+    // Can be called from any thread, or a signal handler.
+    void stop();
+
+private:
+    void handleEvent(ENetEvent& event);
+    void connectClient(ENetPeer* peer, uint32_t clientVersion);
+    void disconnectClient(ENetPeer* peer);
+    void receiveMessage(Client& client, const uint8_t* data, size_t size);
+    void receiveMovement(Client& client, PacketReader& reader);
+    void receiveEditBlock(Client& client, PacketReader& reader);
+    void tick();
+    void applyMovement();
+    void updateInterest();
+    void queueChunks(Client& client, const std::vector<glm::ivec3>& chunks);
+    void streamChunks(Client& client);
+    void sendEdits();
+    void sendEntityPositions();
+    void send(ENetPeer* peer, Channel channel, const PacketWriter& writer);
+    bool sendPacket(ENetPeer* peer, Channel channel, ENetPacket* packet);
+    void broadcast(Channel channel, const PacketWriter& writer);
+    void sendToWatchers(glm::ivec3 chunkPos, Channel channel, const PacketWriter& writer);
+    glm::ivec3 getChunkPos(glm::vec3 pos);
+
+    uint16_t port;
+    ENetHost* host = nullptr;
+    ThreadPool threadPool;
+    World world;
+    WorldGenerator worldGenerator;
+    EntityStore entities;
+    EntityPhysics entityPhysics;
+    StatsReporter statsReporter;
+    ChunkPacketCache chunkPacketCache;
+    InterestManager interestManager;
+    // Edits made since the last tick, sent as one batch per chunk at the end of the tick.
+    EditLog editLog;
+
+    // Indexed by the client's entity id, each peer's data points to its client.
+    std::unordered_map<EntityId, Client> clients;
+    glm::vec3 spawnPos;
+    uint32_t simulationTick = 0;
+    std::atomic<bool> isRunning = false;
+    // Reused between packets to avoid allocating.
+    PacketWriter packetWriter;
+    std::vector<glm::ivec3> enteredChunks;
+    std::vector<glm::ivec3> leftChunks;
+};
\ No newline at end of file
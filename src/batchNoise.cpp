@@ -0,0 +1,260 @@
+#include "batchNoise.hpp"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#define BATCH_NOISE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BATCH_NOISE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Every step below mirrors siv::BasicPerlinNoise::noise3D in the same order of operations,
+// so that no rounding differs between the scalar and vector results.
+
+#if defined(BATCH_NOISE_AVX2)
+
+constexpr size_t batchWidth = 8;
+
+static inline __m256 fade(__m256 t) {
+    __m256 t3 = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+    __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))),
+                                 _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(t3, inner);
+}
+
+static inline __m256 lerp(__m256 a, __m256 b, __m256 t) {
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+}
+
+static inline __m256 grad(__m256i hash, __m256 x, __m256 y, __m256 z) {
+    __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+    __m256 hLessThan8 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), h));
+    __m256 hLessThan4 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+    __m256 hIs12Or14 = _mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)),
+                                                           _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14))));
+
+    __m256 u = _mm256_blendv_ps(y, x, hLessThan8);
+    __m256 v = _mm256_blendv_ps(_mm256_blendv_ps(z, x, hIs12Or14), y, hLessThan4);
+
+    __m256 uSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+    __m256 vSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+
+    return _mm256_add_ps(_mm256_xor_ps(u, uSign), _mm256_xor_ps(v, vSign));
+}
+
+static inline __m256i lookup(const int32_t* permutation, __m256i i) {
+    return _mm256_i32gather_epi32(permutation, i, 4);
+}
+
+static void noise3D_01Wide(const int32_t* permutation, const float* xs, const float* ys, const float* zs, float* results) {
+    __m256i mask = _mm256_set1_epi32(255);
+    __m256i one = _mm256_set1_epi32(1);
+    __m256 oneF = _mm256_set1_ps(1.0f);
+
+    __m256 x = _mm256_loadu_ps(xs);
+    __m256 y = _mm256_loadu_ps(ys);
+    __m256 z = _mm256_loadu_ps(zs);
+
+    __m256 floorX = _mm256_floor_ps(x);
+    __m256 floorY = _mm256_floor_ps(y);
+    __m256 floorZ = _mm256_floor_ps(z);
+
+    __m256i ix = _mm256_and_si256(_mm256_cvttps_epi32(floorX), mask);
+    __m256i iy = _mm256_and_si256(_mm256_cvttps_epi32(floorY), mask);
+    __m256i iz = _mm256_and_si256(_mm256_cvttps_epi32(floorZ), mask);
+
+    __m256 fx = _mm256_sub_ps(x, floorX);
+    __m256 fy = _mm256_sub_ps(y, floorY);
+    __m256 fz = _mm256_sub_ps(z, floorZ);
+
+    __m256 u = fade(fx);
+    __m256 v = fade(fy);
+    __m256 w = fade(fz);
+
+    __m256i a = _mm256_and_si256(_mm256_add_epi32(lookup(permutation, ix), iy), mask);
+    __m256i b = _mm256_and_si256(_mm256_add_epi32(lookup(permutation, _mm256_and_si256(_mm256_add_epi32(ix, one), mask)), iy), mask);
+
+    __m256i aa = _mm256_and_si256(_mm256_add_epi32(lookup(permutation, a), iz), mask);
+    __m256i ab = _mm256_and_si256(_mm256_add_epi32(lookup(permutation, _mm256_and_si256(_mm256_add_epi32(a, one), mask)), iz), mask);
+
+    __m256i ba = _mm256_and_si256(_mm256_add_epi32(lookup(permutation, b), iz), mask);
+    __m256i bb = _mm256_and_si256(_mm256_add_epi32(lookup(permutation, _mm256_and_si256(_mm256_add_epi32(b, one), mask)), iz), mask);
+
+    __m256 fx1 = _mm256_sub_ps(fx, oneF);
+    __m256 fy1 = _mm256_sub_ps(fy, oneF);
+    __m256 fz1 = _mm256_sub_ps(fz, oneF);
+
+    __m256 p0 = grad(lookup(permutation, aa), fx, fy, fz);
+    __m256 p1 = grad(lookup(permutation, ba), fx1, fy, fz);
+    __m256 p2 = grad(lookup(permutation, ab), fx, fy1, fz);
+    __m256 p3 = grad(lookup(permutation, bb), fx1, fy1, fz);
+    __m256 p4 = grad(lookup(permutation, _mm256_and_si256(_mm256_add_epi32(aa, one), mask)), fx, fy, fz1);
+    __m256 p5 = grad(lookup(permutation, _mm256_and_si256(_mm256_add_epi32(ba, one), mask)), fx1, fy, fz1);
+    __m256 p6 = grad(lookup(permutation, _mm256_and_si256(_mm256_add_epi32(ab, one), mask)), fx, fy1, fz1);
+    __m256 p7 = grad(lookup(permutation, _mm256_and_si256(_mm256_add_epi32(bb, one), mask)), fx1, fy1, fz1);
+
+    __m256 q0 = lerp(p0, p1, u);
+    __m256 q1 = lerp(p2, p3, u);
+    __m256 q2 = lerp(p4, p5, u);
+    __m256 q3 = lerp(p6, p7, u);
+
+    __m256 r0 = lerp(q0, q1, v);
+    __m256 r1 = lerp(q2, q3, v);
+
+    __m256 result = lerp(r0, r1, w);
+    __m256 half = _mm256_set1_ps(0.5f);
+    _mm256_storeu_ps(results, _mm256_add_ps(_mm256_mul_ps(result, half), half));
+}
+
+#elif defined(BATCH_NOISE_SSE2)
+
+constexpr size_t batchWidth = 4;
+
+static inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// SSE2 has no floor instruction, so truncate and step down for negative values that had a fraction.
+static inline __m128 floorPs(__m128 x) {
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmplt_ps(x, truncated), _mm_set1_ps(1.0f)));
+}
+
+static inline __m128 fade(__m128 t) {
+    __m128 t3 = _mm_mul_ps(_mm_mul_ps(t, t), t);
+    __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))),
+                              _mm_set1_ps(10.0f));
+    return _mm_mul_ps(t3, inner);
+}
+
+static inline __m128 lerp(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+
+static inline __m128 grad(__m128i hash, __m128 x, __m128 y, __m128 z) {
+    __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+    __m128 hLessThan8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+    __m128 hLessThan4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+    __m128 hIs12Or14 = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                     _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+
+    __m128 u = select(hLessThan8, x, y);
+    __m128 v = select(hLessThan4, y, select(hIs12Or14, x, z));
+
+    __m128 uSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+    __m128 vSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+
+    return _mm_add_ps(_mm_xor_ps(u, uSign), _mm_xor_ps(v, vSign));
+}
+
+static void noise3D_01Wide(const int32_t* permutation, const float* xs, const float* ys, const float* zs, float* results) {
+    __m128 x = _mm_loadu_ps(xs);
+    __m128 y = _mm_loadu_ps(ys);
+    __m128 z = _mm_loadu_ps(zs);
+
+    __m128 floorX = floorPs(x);
+    __m128 floorY = floorPs(y);
+    __m128 floorZ = floorPs(z);
+
+    alignas(16) int32_t ix[batchWidth];
+    alignas(16) int32_t iy[batchWidth];
+    alignas(16) int32_t iz[batchWidth];
+    _mm_store_si128(reinterpret_cast<__m128i*>(ix), _mm_cvttps_epi32(floorX));
+    _mm_store_si128(reinterpret_cast<__m128i*>(iy), _mm_cvttps_epi32(floorY));
+    _mm_store_si128(reinterpret_cast<__m128i*>(iz), _mm_cvttps_epi32(floorZ));
+
+    // SSE2 has no gather, so the hashing is done one lane at a time.
+    alignas(16) int32_t hashes[8][batchWidth];
+
+    for (size_t i = 0; i < batchWidth; i++) {
+        int32_t a = (permutation[ix[i] & 255] + (iy[i] & 255)) & 255;
+        int32_t b = (permutation[(ix[i] + 1) & 255] + (iy[i] & 255)) & 255;
+        int32_t aa = (permutation[a] + (iz[i] & 255)) & 255;
+        int32_t ab = (permutation[(a + 1) & 255] + (iz[i] & 255)) & 255;
+        int32_t ba = (permutation[b] + (iz[i] & 255)) & 255;
+        int32_t bb = (permutation[(b + 1) & 255] + (iz[i] & 255)) & 255;
+
+        hashes[0][i] = permutation[aa];
+        hashes[1][i] = permutation[ba];
+        hashes[2][i] = permutation[ab];
+        hashes[3][i] = permutation[bb];
+        hashes[4][i] = permutation[(aa + 1) & 255];
+        hashes[5][i] = permutation[(ba + 1) & 255];
+        hashes[6][i] = permutation[(ab + 1) & 255];
+        hashes[7][i] = permutation[(bb + 1) & 255];
+    }
+
+    __m128 fx = _mm_sub_ps(x, floorX);
+    __m128 fy = _mm_sub_ps(y, floorY);
+    __m128 fz = _mm_sub_ps(z, floorZ);
+
+    __m128 u = fade(fx);
+    __m128 v = fade(fy);
+    __m128 w = fade(fz);
+
+    __m128 oneF = _mm_set1_ps(1.0f);
+    __m128 fx1 = _mm_sub_ps(fx, oneF);
+    __m128 fy1 = _mm_sub_ps(fy, oneF);
+    __m128 fz1 = _mm_sub_ps(fz, oneF);
+
+    auto hash = [&](size_t corner) {
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(hashes[corner]));
+    };
+
+    __m128 p0 = grad(hash(0), fx, fy, fz);
+    __m128 p1 = grad(hash(1), fx1, fy, fz);
+    __m128 p2 = grad(hash(2), fx, fy1, fz);
+    __m128 p3 = grad(hash(3), fx1, fy1, fz);
+    __m128 p4 = grad(hash(4), fx, fy, fz1);
+    __m128 p5 = grad(hash(5), fx1, fy, fz1);
+    __m128 p6 = grad(hash(6), fx, fy1, fz1);
+    __m128 p7 = grad(hash(7), fx1, fy1, fz1);
+
+    __m128 q0 = lerp(p0, p1, u);
+    __m128 q1 = lerp(p2, p3, u);
+    __m128 q2 = lerp(p4, p5, u);
+    __m128 q3 = lerp(p6, p7, u);
+
+    __m128 r0 = lerp(q0, q1, v);
+    __m128 r1 = lerp(q2, q3, v);
+
+    __m128 result = lerp(r0, r1, w);
+    __m128 half = _mm_set1_ps(0.5f);
+    _mm_storeu_ps(results, _mm_add_ps(_mm_mul_ps(result, half), half));
+}
+
+#endif
+
+BatchNoise::BatchNoise(const siv::BasicPerlinNoise<float>& noise) : noise(noise) {
+    const auto& state = noise.serialize();
+
+    for (size_t i = 0; i < permutation.size(); i++) {
+        permutation[i] = state[i];
+    }
+}
+
+void BatchNoise::noise2D_01(const float* xs, const float* ys, float* results, size_t count) {
+    constexpr size_t blockSize = 64;
+    std::array<float, blockSize> zs;
+    zs.fill(static_cast<float>(SIVPERLIN_DEFAULT_Z));
+
+    for (size_t i = 0; i < count; i += blockSize) {
+        noise3D_01(xs + i, ys + i, zs.data(), results + i, std::min(blockSize, count - i));
+    }
+}
+
+void BatchNoise::noise3D_01(const float* xs, const float* ys, const float* zs, float* results, size_t count) {
+    size_t i = 0;
+
+#if defined(BATCH_NOISE_AVX2) || defined(BATCH_NOISE_SSE2)
+    for (; i + batchWidth <= count; i += batchWidth) {
+        noise3D_01Wide(permutation.data(), xs + i, ys + i, zs + i, results + i);
+    }
+#endif
+
+    for (; i < count; i++) {
+        results[i] = noise.noise3D_01(xs[i], ys[i], zs[i]);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cinttypes>
+#include <array>
+
+#include "../deps/perlinNoise.hpp"
+
+// Evaluates siv::BasicPerlinNoise for many points at once, using AVX2 when the build enables it,
+// SSE2 otherwise, and falling back to the scalar noise on other platforms. The results match the
+// scalar noise bit for bit.
+class BatchNoise {
+public:
+    BatchNoise(const siv::BasicPerlinNoise<float>& noise);
+    void noise2D_01(const float* xs, const float* ys, float* results, size_t count);
+    void noise3D_01(const float* xs, const float* ys, const float* zs, float* results, size_t count);
+
+private:
+    siv::BasicPerlinNoise<float> noise;
+    std::array<int32_t, 256> permutation;
+};
\ No newline at end of file
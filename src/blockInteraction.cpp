@@ -3,12 +3,6 @@
 constexpr float blockModelPadding = 0.0025f;
 constexpr float blockModelScale = 1.0f + blockModelPadding * 2.0f;
 
-void BlockInteraction::init(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device) {
-    model = Model<TransparentVertexData, uint32_t, InstanceData>::create(1, allocator, commands, graphicsQueue, device);
-    instances.push_back(InstanceData{glm::vec3(0.0f, 0.0f, 0.0f)});
-    model.updateInstances(instances, commands, allocator, graphicsQueue, device);
-}
-
 Blocks BlockInteraction::mineBlock(World& world, int32_t x, int32_t y, int32_t z, float deltaTime) {
     Blocks block = world.getBlock(x, y, z);
     int32_t key = hashVector(x, y, z);
@@ -53,7 +47,7 @@ void BlockInteraction::preUpdate() {
     }
 }
 
-void BlockInteraction::postUpdate(Commands& commands, VmaAllocator allocator, VkQueue graphicsQueue, VkDevice device) {
+void BlockInteraction::postUpdate() {
     vertices.clear();
     indices.clear();
 
@@ -86,14 +80,12 @@ void BlockInteraction::postUpdate(Commands& commands, VmaAllocator allocator, Vk
 
         it++;
     }
-
-    model.update(vertices, indices, commands, allocator, graphicsQueue, device);
 }
 
-void BlockInteraction::draw(VkCommandBuffer commandBuffer) {
-    model.draw(commandBuffer);
+std::vector<TransparentVertexData>& BlockInteraction::getVertices() {
+    return vertices;
 }
 
-void BlockInteraction::destroy(VmaAllocator allocator) {
-    model.destroy(allocator);
+std::vector<uint32_t>& BlockInteraction::getIndices() {
+    return indices;
 }
\ No newline at end of file
@@ -10,7 +10,7 @@
 #include "blocks.hpp"
 #include "gameMath.hpp"
 #include "world.hpp"
-#include "renderTypes.hpp"
+#include "meshTypes.hpp"
 #include "cubeMesh.hpp"
 
 const float blockBreakTime = 0.5f;
@@ -24,19 +24,17 @@ struct BreakingBlock {
 
 class BlockInteraction {
 public:
-    void init(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device);
     Blocks mineBlock(World& world, int32_t x, int32_t y, int32_t z, float deltaTime);
     void placeBlock(World& world, int32_t x, int32_t y, int32_t z, Blocks block);
     void preUpdate();
-    void postUpdate(Commands& commands, VmaAllocator allocator, VkQueue graphicsQueue, VkDevice device);
-    void draw(VkCommandBuffer commandBuffer);
-    void destroy(VmaAllocator allocator);
+    void postUpdate();
+    std::vector<TransparentVertexData>& getVertices();
+    std::vector<uint32_t>& getIndices();
 
 private:
     std::unordered_map<int32_t, BreakingBlock> breakingBlocks;
-    Model<TransparentVertexData, uint32_t, InstanceData> model;
 
+    // Overlay showing how far along each block being mined is.
     std::vector<TransparentVertexData> vertices;
     std::vector<uint32_t> indices;
-    std::vector<InstanceData> instances;
 };
\ No newline at end of file
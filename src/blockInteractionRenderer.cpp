@@ -0,0 +1,26 @@
+#include "blockInteractionRenderer.hpp"
+
+#include "stats.hpp"
+
+void BlockInteractionRenderer::init(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device) {
+    model = Model<TransparentVertexData, uint32_t, InstanceData>::create(1, allocator, commands, graphicsQueue, device);
+    instances.push_back(InstanceData{glm::vec3(0.0f, 0.0f, 0.0f)});
+    model.updateInstances(instances, commands, allocator, graphicsQueue, device);
+}
+
+void BlockInteractionRenderer::upload(BlockInteraction& blockInteraction, Commands& commands, VmaAllocator allocator, VkQueue graphicsQueue, VkDevice device) {
+    std::vector<TransparentVertexData>& vertices = blockInteraction.getVertices();
+    std::vector<uint32_t>& indices = blockInteraction.getIndices();
+
+    model.update(vertices, indices, commands, allocator, graphicsQueue, device);
+    addCounter(Counter::BytesUploaded, vertices.size() * sizeof(TransparentVertexData) + indices.size() * sizeof(uint32_t));
+}
+
+void BlockInteractionRenderer::draw(VkCommandBuffer commandBuffer) {
+    model.draw(commandBuffer);
+    addCounter(Counter::DrawCalls);
+}
+
+void BlockInteractionRenderer::destroy(VmaAllocator allocator) {
+    model.destroy(allocator);
+}
\ No newline at end of file
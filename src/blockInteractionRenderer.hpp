@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include <vkFrame/renderer.hpp>
+
+#include "blockInteraction.hpp"
+#include "renderTypes.hpp"
+
+// Draws the overlay on blocks that are being mined.
+class BlockInteractionRenderer {
+public:
+    void init(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device);
+    void upload(BlockInteraction& blockInteraction, Commands& commands, VmaAllocator allocator, VkQueue graphicsQueue, VkDevice device);
+    void draw(VkCommandBuffer commandBuffer);
+    void destroy(VmaAllocator allocator);
+
+private:
+    Model<TransparentVertexData, uint32_t, InstanceData> model;
+    std::vector<InstanceData> instances;
+};
\ No newline at end of file
@@ -4,4 +4,7 @@ enum class Blocks : unsigned char {
     Air,
     Dirt,
     Stone,
-};
\ No newline at end of file
+};
+
+// How many block types there are, for checking blocks that come from outside of the game.
+constexpr unsigned char blockTypeCount = 3;
\ No newline at end of file
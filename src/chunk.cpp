@@ -1,32 +1,45 @@
 #include "chunk.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
 #include "world.hpp"
+#include "profiler.hpp"
+#include "stats.hpp"
 
-const float shadeNoiseScale = 0.2f;
-const float hillNoiseScale = 0.05f;
-const float hillHeight = 64.0f;
-const float valleyHeight = 32.0f;
 const float caveNoiseScale = 0.1f;
 const float caveNoiseSolidThreshold = 0.7f;
 
 Chunk::Chunk(int32_t size, int32_t x, int32_t y, int32_t z) : chunkX(x), chunkY(y), chunkZ(z), size(size) {
+    // Bricks have to tile the chunk exactly, or block counts would be kept for bricks that don't exist.
+    assert(size > 0 && size % brickSize == 0);
+
     data.resize(size * size * size);
-    shadeNoise.resize(size * size * size);
-    lightMap.resize(size * size * size, true);
-    instances.push_back(InstanceData{glm::vec3(chunkX * size, chunkY * size, chunkZ * size)});
+    bricksPerAxis = size / brickSize;
+    brickBlockCounts.resize(bricksPerAxis * bricksPerAxis * bricksPerAxis, 0);
+    lightMap.resize(size * size * size, 0);
 }
 
 int32_t Chunk::getBlockIndex(int32_t x, int32_t y, int32_t z) {
     return x + y * size + z * size * size;
 }
 
-bool Chunk::setBlock(World& world, int32_t x, int32_t y, int32_t z, Blocks type) {
+bool Chunk::setBlock(int32_t x, int32_t y, int32_t z, Blocks type) {
     if (x < 0 || x >= size || y < 0 || y >= size || z < 0 || z >= size) return false;
 
-    data[getBlockIndex(x, y, z)] = type;
-    needsUpdate = true;
+    Blocks& block = data[getBlockIndex(x, y, z)];
+    int32_t occupancyChange = static_cast<int32_t>(type != Blocks::Air) - static_cast<int32_t>(block != Blocks::Air);
 
-    setLitColumn(world, x, y - 1, z, type == Blocks::Air ? getLit(x, y, z) : false);
+    if (occupancyChange != 0) {
+        int32_t brickIndex = x / brickSize + (y / brickSize) * bricksPerAxis + (z / brickSize) * bricksPerAxis * bricksPerAxis;
+        brickBlockCounts[brickIndex] += occupancyChange;
+        blockCount += occupancyChange;
+    }
+
+    block = type;
+    version++;
+    needsUpdate = true;
 
     return true;
 }
@@ -41,56 +54,65 @@ bool Chunk::isBlockOccupied(int32_t x, int32_t y, int32_t z) {
     return getBlock(x, y, z) != Blocks::Air;
 }
 
-void Chunk::setLitColumn(World& world, int32_t x, int32_t topY, int32_t z, bool lit) {
-    for (int32_t y = topY; y >= 0; y--) {
-        if (getLit(x, y, z) == lit) {
-            return;
-        }
+const Blocks* Chunk::getBlockData() {
+    return data.data();
+}
 
-        setLit(x, y, z, lit);
+bool Chunk::isEmpty() {
+    return blockCount == 0;
+}
 
-        if (isBlockOccupied(x, y, z)) {
-            return;
-        }
-    }
+// Check if the brick containing a block has nothing in it.
+bool Chunk::isBrickEmpty(int32_t x, int32_t y, int32_t z) {
+    int32_t brickIndex = x / brickSize + (y / brickSize) * bricksPerAxis + (z / brickSize) * bricksPerAxis * bricksPerAxis;
+    return brickBlockCounts[brickIndex] == 0;
+}
 
-    if (chunkY == 0) {
-        return;
-    }
+uint32_t Chunk::getVersion() {
+    return version;
+}
 
-    world.getChunk(chunkX, chunkY - 1, chunkZ).setLitColumn(world, x, size - 1, z, lit);
+// Light is stored in columns, so that walking up and down is cache friendly.
+int32_t Chunk::getLightIndex(int32_t x, int32_t y, int32_t z) {
+    return y + x * size + z * size * size;
 }
 
-void Chunk::setLit(int32_t x, int32_t y, int32_t z, bool lit) {
-    lightMap[y + x * size + z * size * size] = lit;
+void Chunk::setLight(int32_t x, int32_t y, int32_t z, LightChannel channel, uint8_t level) {
+    uint8_t& light = lightMap[getLightIndex(x, y, z)];
+
+    if (channel == LightChannel::Sky) {
+        light = (light & 0x0f) | (level << 4);
+    } else {
+        light = (light & 0xf0) | level;
+    }
+
     needsUpdate = true;
 }
 
-bool Chunk::getLit(int32_t x, int32_t y, int32_t z) {
-    return lightMap[y + x * size + z * size * size];
-}
+uint8_t Chunk::getLight(int32_t x, int32_t y, int32_t z, LightChannel channel) {
+    uint8_t light = lightMap[getLightIndex(x, y, z)];
 
-bool Chunk::update(World& world, VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device) {
-    if (needsUpdate) {
-        updateMesh(world, allocator, commands, graphicsQueue, device);
-        needsUpdate = false;
-        return true;
+    if (channel == LightChannel::Sky) {
+        return light >> 4;
     }
 
-    return false;
+    return light & 0x0f;
 }
 
-bool Chunk::upload(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device) {
-    if (needsUpload) {
-        uploadMesh(allocator, commands, graphicsQueue, device);
-        needsUpload = false;
+bool Chunk::update(World& world) {
+    // Cleared before meshing, so changes made while the mesh is built flag the chunk again.
+    if (needsUpdate.exchange(false)) {
+        updateMesh(world);
         return true;
     }
 
     return false;
 }
 
-void Chunk::updateMesh(World& world, VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device) {
+void Chunk::updateMesh(World& world) {
+    PROFILE_ZONE("Chunk::updateMesh");
+    auto startTime = std::chrono::steady_clock::now();
+
     vertices.clear();
     indices.clear();
 
@@ -104,16 +126,19 @@ void Chunk::updateMesh(World& world, VmaAllocator allocator, Commands& commands,
 
                 if (block == Blocks::Air) continue;
 
-                float noiseValue = shadeNoise[x + y * size + z * size * size];
+                // Each block gets a slightly different shade, derived from its position so nothing has to be stored.
+                // The range is kept close to the spread of the shade noise that was used before.
+                float noiseValue = 0.35f + hashToUnitFloat(worldX, worldY, worldZ) * 0.3f;
 
                 for (int32_t face = 0; face < 6; face++) {
                     if (world.isBlockOccupied(worldX + directions[face][0], worldY + directions[face][1],
                                 worldZ + directions[face][2]))
                         continue;
 
-                    float lightLevel = world.getLit(worldX + directions[face][0],
-                                                    worldY + directions[face][1],
-                                                    worldZ + directions[face][2]) ? 1.0f : 0.7f;
+                    uint8_t faceLight = world.getLightLevel(worldX + directions[face][0],
+                                                            worldY + directions[face][1],
+                                                            worldZ + directions[face][2]);
+                    float lightLevel = 0.7f + 0.3f * faceLight / maxLightLevel;
 
                     size_t vertexCount = vertices.size();
                     for (uint32_t index : cubeIndices[face]) {
@@ -145,48 +170,63 @@ void Chunk::updateMesh(World& world, VmaAllocator allocator, Commands& commands,
     }
 
     needsUpload = true;
+
+    addCounter(Counter::ChunksMeshed);
+    addCounter(Counter::VerticesEmitted, vertices.size());
+    addCounter(Counter::IndicesEmitted, indices.size());
+    auto endTime = std::chrono::steady_clock::now();
+    recordHistogram(Histogram::ChunkMeshTime, std::chrono::duration<float, std::milli>(endTime - startTime).count());
 }
 
-void Chunk::uploadMesh(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device) {
-    if (firstUpdate) {
-        model = Model<VertexData, uint32_t, InstanceData>::fromVerticesAndIndices(vertices, indices, 1, allocator, commands, graphicsQueue, device);
-        model.updateInstances(instances, commands, allocator, graphicsQueue, device);
-        firstUpdate = false;
-    }
-    else {
-        model.update(vertices, indices, commands, allocator, graphicsQueue, device);
+// Fill everything below the surface, caves are carved out of it afterwards.
+void Chunk::generateTerrain(ColumnHeightmap& heightmap) {
+    PROFILE_ZONE("Chunk::generateTerrain");
+
+    int32_t worldY = chunkY * size;
+
+    // Chunks above the highest point of the column are left empty.
+    if (worldY > heightmap.maxHeight) return;
+
+    for (int32_t z = 0; z < size; z++) {
+        for (int32_t x = 0; x < size; x++) {
+            int32_t solidHeight = std::clamp(heightmap.getHeight(x, z, size) - worldY + 1, 0, size);
+
+            for (int32_t y = 0; y < solidHeight; y++) {
+                setBlock(x, y, z, Blocks::Dirt);
+            }
+        }
     }
 }
 
-void Chunk::generate(World& world, std::mt19937& rng, siv::BasicPerlinNoise<float>& noise) {
-    for (int32_t z = 0; z < size; z++) {
-        int32_t worldZ = z + chunkZ * size;
+void Chunk::generateCaves(BatchNoise& noise, TerrainSettings settings, ColumnHeightmap& heightmap) {
+    PROFILE_ZONE("Chunk::generateCaves");
 
-        for (int32_t x = 0; x < size; x++) {
-            int32_t worldX = x + chunkX * size;
+    glm::ivec3 worldPos(chunkX * size, chunkY * size, chunkZ * size);
 
-            int32_t maxHeight = floorToInt(noise.noise2D_01(worldX * hillNoiseScale, worldZ * hillNoiseScale) * hillHeight + valleyHeight);
+    if (worldPos.y > heightmap.maxHeight) return;
 
-            for (int32_t y = 0; y < size; y++) {
-                int32_t worldY = y + chunkY * size;
+    TerrainNoiseField caveNoiseField(noise, caveNoiseScale, settings, size, worldPos);
 
-                float shadeNoiseValue = noise.noise3D_01(worldX * shadeNoiseScale, worldY * shadeNoiseScale, worldZ * shadeNoiseScale);
-                shadeNoise[x + y * size + z * size * size] = shadeNoiseValue;
+    // No caves pass through chunks where the cave noise never reaches the threshold.
+    if (caveNoiseField.isAlwaysBelow(caveNoiseSolidThreshold)) return;
 
-                if (worldY > maxHeight) continue;
+    std::vector<float> caveNoise(size);
+
+    for (int32_t z = 0; z < size; z++) {
+        for (int32_t x = 0; x < size; x++) {
+            // Only the part of the column below the surface has anything to carve.
+            int32_t solidHeight = std::clamp(heightmap.getHeight(x, z, size) - worldPos.y + 1, 0, size);
+            caveNoiseField.sampleColumn(x, z, solidHeight, caveNoise.data());
 
-                if (shouldGenerateSolid(noise, worldX, worldY, worldZ)) {
-                    setBlock(world, x, y, z, Blocks::Dirt);
+            for (int32_t y = 0; y < solidHeight; y++) {
+                if (!shouldGenerateSolid(caveNoise[y])) {
+                    setBlock(x, y, z, Blocks::Air);
                 }
             }
         }
     }
 }
 
-void Chunk::draw(VkCommandBuffer commandBuffer) {
-    model.draw(commandBuffer);
-}
-
 glm::vec3 Chunk::getPos() {
     return glm::vec3(chunkX * size, chunkY * size, chunkZ * size);
 }
@@ -195,13 +235,16 @@ glm::vec3 Chunk::getSize() {
     return glm::vec3(size, size, size);
 }
 
-void Chunk::destroy(VmaAllocator allocator) {
-    model.destroy(allocator);
+std::vector<VertexData>& Chunk::getVertices() {
+    return vertices;
+}
+
+std::vector<uint32_t>& Chunk::getIndices() {
+    return indices;
 }
 
-bool Chunk::shouldGenerateSolid(siv::BasicPerlinNoise<float>& noise, int32_t worldX, int32_t worldY, int32_t worldZ) {
-    float noiseValue = noise.noise3D_01(worldX * caveNoiseScale, worldY * caveNoiseScale, worldZ * caveNoiseScale);
-    return noiseValue < caveNoiseSolidThreshold;
+bool Chunk::shouldGenerateSolid(float caveNoiseValue) {
+    return caveNoiseValue < caveNoiseSolidThreshold;
 }
 
 int32_t Chunk::calculateAoLevel(VertexNeighbors neighbors) {
@@ -5,62 +5,77 @@
 #include <vector>
 #include <random>
 #include <array>
+#include <atomic>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <vkFrame/renderer.hpp>
 
 #include "cubeMesh.hpp"
 #include "blocks.hpp"
-#include "renderTypes.hpp"
+#include "meshTypes.hpp"
 #include "directions.hpp"
 #include "gameMath.hpp"
 #include "vertexNeighbors.hpp"
-#include "../deps/perlinNoise.hpp"
+#include "lighting.hpp"
+#include "batchNoise.hpp"
+#include "terrainNoise.hpp"
 
 class World;
 
+// Chunks keep a count of the solid blocks in each brick of brickSize^3 blocks, so rays can skip over
+// empty space. Chunk sizes need to be a multiple of the brick size.
+constexpr int32_t brickSize = 8;
+
 class Chunk {
 public:
     Chunk(int32_t size, int32_t x, int32_t y, int32_t z);
     int32_t getBlockIndex(int32_t x, int32_t y, int32_t z);
-    bool setBlock(World& world, int32_t x, int32_t y, int32_t z, Blocks type);
+    bool setBlock(int32_t x, int32_t y, int32_t z, Blocks type);
     Blocks getBlock(int32_t x, int32_t y, int32_t z);
     bool isBlockOccupied(int32_t x, int32_t y, int32_t z);
-    void setLitColumn(World& world, int32_t x, int32_t topY, int32_t z, bool lit);
-    void setLit(int32_t x, int32_t y, int32_t z, bool lit);
-    bool getLit(int32_t x, int32_t y, int32_t z);
-    bool update(World& world, VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device);
-    bool upload(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device);
-    void updateMesh(World& world, VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device);
-    void uploadMesh(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device);
-    void generate(World& world, std::mt19937& rng, siv::BasicPerlinNoise<float>& noise);
-    void draw(VkCommandBuffer commandBuffer);
+    // Blocks indexed by getBlockIndex, for loops that do their own bounds checks.
+    const Blocks* getBlockData();
+    bool isEmpty();
+    bool isBrickEmpty(int32_t x, int32_t y, int32_t z);
+    // Changes every time a block in the chunk does, so copies of the blocks can tell when they're stale.
+    uint32_t getVersion();
+    int32_t getLightIndex(int32_t x, int32_t y, int32_t z);
+    void setLight(int32_t x, int32_t y, int32_t z, LightChannel channel, uint8_t level);
+    uint8_t getLight(int32_t x, int32_t y, int32_t z, LightChannel channel);
+    bool update(World& world);
+    void updateMesh(World& world);
+    void generateTerrain(ColumnHeightmap& heightmap);
+    void generateCaves(BatchNoise& noise, TerrainSettings settings, ColumnHeightmap& heightmap);
     glm::vec3 getPos();
     glm::vec3 getSize();
-    void destroy(VmaAllocator allocator);
+    std::vector<VertexData>& getVertices();
+    std::vector<uint32_t>& getIndices();
     int32_t calculateAoLevel(VertexNeighbors neighbors);
     VertexNeighbors checkVertexNeighbors(World& world, glm::ivec3 worldPos, glm::ivec3 vertexPos, int32_t direction);
     void orientLastFace();
 
-    bool firstUpdate = true;
-    bool needsUpdate = true;
+    // Set from any thread that changes the chunk or the light around it.
+    std::atomic<bool> needsUpdate = true;
+    // Set when the mesh changes, until the renderer picks it up.
     bool needsUpload = false;
+    // Set by the generator's workers and read by the threads that mesh and edit the world.
+    std::atomic<bool> isGenerated = false;
 
 private:
-    bool shouldGenerateSolid(siv::BasicPerlinNoise<float>& noise, int32_t worldX, int32_t worldY, int32_t worldZ);
+    bool shouldGenerateSolid(float caveNoiseValue);
 
     int32_t chunkX, chunkY, chunkZ;
     int32_t size;
 
     std::vector<Blocks> data;
-    std::vector<bool> lightMap;
-    std::vector<float> shadeNoise;
+    int32_t bricksPerAxis;
+    std::vector<uint16_t> brickBlockCounts;
+    int32_t blockCount = 0;
+    uint32_t version = 0;
+    // Sky light is stored in the high 4 bits, block light in the low 4 bits.
+    std::vector<uint8_t> lightMap;
 
     std::vector<VertexData> vertices;
     std::vector<uint32_t> indices;
     std::array<int32_t, 4> aoBuffer;
-
-    std::vector<InstanceData> instances;
-    Model<VertexData, uint32_t, InstanceData> model;
 };
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "chunkCodec.hpp"
+
+#include <array>
+#include <algorithm>
+#include <cstring>
+
+#include "profiler.hpp"
+
+constexpr size_t maxPaletteSize = 256;
+constexpr int32_t noPaletteIndex = -1;
+
+class BitWriter {
+public:
+    BitWriter(std::vector<uint8_t>& data) : data(data) {}
+
+    void write(uint32_t value, int32_t bitCount) {
+        buffer |= static_cast<uint64_t>(value) << bufferedBits;
+        bufferedBits += bitCount;
+
+        while (bufferedBits >= 8) {
+            data.push_back(static_cast<uint8_t>(buffer));
+            buffer >>= 8;
+            bufferedBits -= 8;
+        }
+    }
+
+    void flush() {
+        if (bufferedBits > 0) {
+            data.push_back(static_cast<uint8_t>(buffer));
+        }
+
+        buffer = 0;
+        bufferedBits = 0;
+    }
+
+private:
+    std::vector<uint8_t>& data;
+    uint64_t buffer = 0;
+    int32_t bufferedBits = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    bool read(uint32_t& value, int32_t bitCount) {
+        while (bufferedBits < bitCount) {
+            if (offset >= size) return false;
+
+            buffer |= static_cast<uint64_t>(data[offset]) << bufferedBits;
+            offset++;
+            bufferedBits += 8;
+        }
+
+        value = static_cast<uint32_t>(buffer & ((static_cast<uint64_t>(1) << bitCount) - 1));
+        buffer >>= bitCount;
+        bufferedBits -= bitCount;
+
+        return true;
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+    uint64_t buffer = 0;
+    int32_t bufferedBits = 0;
+};
+
+// Bits needed to store every value below count.
+static int32_t getBitCount(uint32_t count) {
+    int32_t bitCount = 0;
+
+    while (bitCount < 32 && (static_cast<uint64_t>(1) << bitCount) < count) {
+        bitCount++;
+    }
+
+    return bitCount;
+}
+
+static size_t getByteCount(size_t bitCount) {
+    return (bitCount + 7) / 8;
+}
+
+ChunkCodec::ChunkCodec(int32_t chunkSize) : chunkSize(chunkSize), blockCount(chunkSize * chunkSize * chunkSize) {
+    columnBlocks.resize(blockCount);
+}
+
+// Copy the blocks into the order they're encoded in and split them into runs.
+void ChunkCodec::findRuns(const Blocks* blocks) {
+    runs.clear();
+
+    const uint8_t* blockBytes = reinterpret_cast<const uint8_t*>(blocks);
+    int32_t i = 0;
+
+    for (int32_t z = 0; z < chunkSize; z++) {
+        for (int32_t x = 0; x < chunkSize; x++) {
+            const uint8_t* column = blockBytes + x + z * chunkSize * chunkSize;
+
+            for (int32_t y = 0; y < chunkSize; y++) {
+                uint8_t block = column[y * chunkSize];
+                columnBlocks[i] = block;
+                i++;
+
+                if (!runs.empty() && runs.back().block == block) {
+                    runs.back().length++;
+                } else {
+                    runs.push_back(Run{block, 1});
+                }
+            }
+        }
+    }
+}
+
+void ChunkCodec::encode(const Blocks* blocks, std::vector<uint8_t>& data) {
+    PROFILE_ZONE("ChunkCodec::encode");
+
+    findRuns(blocks);
+
+    std::array<int32_t, maxPaletteSize> paletteIndices;
+    paletteIndices.fill(noPaletteIndex);
+    palette.clear();
+    int32_t maxRunLength = 0;
+
+    for (Run& run : runs) {
+        if (paletteIndices[run.block] == noPaletteIndex) {
+            paletteIndices[run.block] = static_cast<int32_t>(palette.size());
+            palette.push_back(run.block);
+        }
+
+        maxRunLength = std::max(maxRunLength, run.length);
+    }
+
+    int32_t indexBits = getBitCount(static_cast<uint32_t>(palette.size()));
+    int32_t runLengthBits = getBitCount(static_cast<uint32_t>(maxRunLength));
+    size_t paletteHeaderSize = 1 + palette.size();
+    size_t rawSize = blockCount;
+    size_t packedSize = paletteHeaderSize + getByteCount(static_cast<size_t>(blockCount) * indexBits);
+    size_t runsSize = paletteHeaderSize + 1 + getByteCount(runs.size() * (indexBits + runLengthBits));
+
+    if (rawSize <= packedSize && rawSize <= runsSize) {
+        data.push_back(static_cast<uint8_t>(ChunkEncoding::Raw));
+        const uint8_t* blockBytes = reinterpret_cast<const uint8_t*>(blocks);
+        data.insert(data.end(), blockBytes, blockBytes + blockCount);
+        return;
+    }
+
+    bool useRuns = runsSize < packedSize;
+    data.push_back(static_cast<uint8_t>(useRuns ? ChunkEncoding::Runs : ChunkEncoding::Packed));
+    data.push_back(static_cast<uint8_t>(palette.size() - 1));
+    data.insert(data.end(), palette.begin(), palette.end());
+
+    BitWriter writer(data);
+
+    if (useRuns) {
+        data.push_back(static_cast<uint8_t>(runLengthBits));
+
+        // Runs are never empty, so lengths are stored minus one.
+        for (Run run : runs) {
+            writer.write(static_cast<uint32_t>(paletteIndices[run.block]), indexBits);
+            writer.write(static_cast<uint32_t>(run.length - 1), runLengthBits);
+        }
+    } else {
+        for (uint8_t block : columnBlocks) {
+            writer.write(static_cast<uint32_t>(paletteIndices[block]), indexBits);
+        }
+    }
+
+    writer.flush();
+}
+
+bool ChunkCodec::decode(const uint8_t* data, size_t size, Blocks* blocks) {
+    PROFILE_ZONE("ChunkCodec::decode");
+
+    if (size < 1) return false;
+
+    ChunkEncoding encoding = static_cast<ChunkEncoding>(data[0]);
+    data++;
+    size--;
+
+    if (encoding == ChunkEncoding::Raw) {
+        if (size != static_cast<size_t>(blockCount)) return false;
+
+        for (size_t i = 0; i < size; i++) {
+            if (data[i] >= blockTypeCount) return false;
+        }
+
+        std::memcpy(blocks, data, size);
+        return true;
+    }
+
+    if (encoding != ChunkEncoding::Packed && encoding != ChunkEncoding::Runs) return false;
+    if (size < 1) return false;
+
+    size_t paletteSize = static_cast<size_t>(data[0]) + 1;
+    data++;
+    size--;
+
+    if (size < paletteSize) return false;
+
+    const uint8_t* palette = data;
+    data += paletteSize;
+    size -= paletteSize;
+
+    for (size_t i = 0; i < paletteSize; i++) {
+        if (palette[i] >= blockTypeCount) return false;
+    }
+
+    int32_t indexBits = getBitCount(static_cast<uint32_t>(paletteSize));
+    int32_t runLengthBits = 0;
+
+    if (encoding == ChunkEncoding::Runs) {
+        if (size < 1) return false;
+
+        runLengthBits = data[0];
+        data++;
+        size--;
+
+        if (runLengthBits > getBitCount(static_cast<uint32_t>(blockCount))) return false;
+    }
+
+    BitReader reader(data, size);
+    uint32_t paletteIndex = 0;
+    uint32_t runLength = 0;
+
+    for (int32_t z = 0; z < chunkSize; z++) {
+        for (int32_t x = 0; x < chunkSize; x++) {
+            Blocks* column = blocks + x + z * chunkSize * chunkSize;
+
+            for (int32_t y = 0; y < chunkSize; y++) {
+                if (runLength == 0) {
+                    if (!reader.read(paletteIndex, indexBits) || paletteIndex >= paletteSize) return false;
+
+                    if (encoding == ChunkEncoding::Runs) {
+                        if (!reader.read(runLength, runLengthBits)) return false;
+                        runLength++;
+                    } else {
+                        runLength = 1;
+                    }
+                }
+
+                column[y * chunkSize] = static_cast<Blocks>(palette[paletteIndex]);
+                runLength--;
+            }
+        }
+    }
+
+    // A run that's longer than the rest of the chunk would have been cut short.
+    return runLength == 0;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include "blocks.hpp"
+
+// How a chunk's blocks are stored, the encoder picks whichever is smallest.
+enum class ChunkEncoding : uint8_t {
+    // Every block as a byte, for chunks too noisy for anything else to help.
+    Raw,
+    // A palette of the block types in the chunk, then a bit-packed palette index for each block.
+    Packed,
+    // A palette, then bit-packed runs of the same block. Each run is a palette index and a length.
+    Runs,
+};
+
+// Compresses chunks for the network and for disk. Blocks are visited one column at a time along
+// the y axis, where terrain has the longest runs of the same block.
+//
+// Encoded chunks start with the ChunkEncoding. Packed and Runs follow it with the palette size minus one
+// and the palette, Runs then has the number of bits in each run length. The rest is a bit stream, filled
+// from the lowest bit of each byte up.
+class ChunkCodec {
+public:
+    ChunkCodec(int32_t chunkSize);
+    // Append the encoded blocks, which are indexed by Chunk::getBlockIndex, to data.
+    void encode(const Blocks* blocks, std::vector<uint8_t>& data);
+    // Returns false if the data isn't a valid chunk, encoded chunks can come from outside of the game.
+    bool decode(const uint8_t* data, size_t size, Blocks* blocks);
+
+private:
+    struct Run {
+        uint8_t block;
+        int32_t length;
+    };
+
+    void findRuns(const Blocks* blocks);
+
+    int32_t chunkSize;
+    int32_t blockCount;
+    // The blocks in the order they're encoded.
+    std::vector<uint8_t> columnBlocks;
+    std::vector<Run> runs;
+    std::vector<uint8_t> palette;
+};
\ No newline at end of file
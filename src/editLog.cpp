@@ -0,0 +1,118 @@
+#include "editLog.hpp"
+
+#include <algorithm>
+
+EditLog::EditLog(int32_t chunkSize, int32_t mapSizeInChunks) : chunkSize(chunkSize), mapSizeInChunks(mapSizeInChunks) {
+    batchIndices.resize(mapSizeInChunks * mapSizeInChunks * mapSizeInChunks, -1);
+}
+
+void EditLog::record(int32_t x, int32_t y, int32_t z, Blocks block) {
+    glm::ivec3 chunkPos(x / chunkSize, y / chunkSize, z / chunkSize);
+    int32_t& batchIndex = batchIndices[getChunkIndex(chunkPos)];
+
+    if (batchIndex < 0) {
+        batchIndex = static_cast<int32_t>(editedChunks.size());
+        editedChunks.push_back(chunkPos);
+
+        // Edit lists are kept between ticks so they don't have to be reallocated.
+        if (chunkEdits.size() < editedChunks.size()) {
+            chunkEdits.emplace_back();
+        }
+    }
+
+    int32_t localX = x % chunkSize;
+    int32_t localY = y % chunkSize;
+    int32_t localZ = z % chunkSize;
+    chunkEdits[batchIndex].push_back(LocalEdit{localX + localY * chunkSize + localZ * chunkSize * chunkSize, block});
+}
+
+const std::vector<glm::ivec3>& EditLog::getEditedChunks() {
+    return editedChunks;
+}
+
+void EditLog::writeBatch(glm::ivec3 chunkPos, uint32_t version, PacketWriter& writer) {
+    std::vector<LocalEdit>& edits = chunkEdits[batchIndices[getChunkIndex(chunkPos)]];
+
+    // Only the last edit to each block matters, the stable sort keeps edits to the same block in order.
+    std::stable_sort(edits.begin(), edits.end(), [](LocalEdit a, LocalEdit b) {
+        return a.index < b.index;
+    });
+
+    size_t uniqueCount = 0;
+
+    for (size_t i = 0; i < edits.size(); i++) {
+        if (i + 1 < edits.size() && edits[i + 1].index == edits[i].index) continue;
+
+        edits[uniqueCount] = edits[i];
+        uniqueCount++;
+    }
+
+    edits.resize(uniqueCount);
+
+    writer.writeU8(static_cast<uint8_t>(MessageType::BlockEdits));
+    writer.writeU32(version);
+    writer.writeI32(chunkPos.x);
+    writer.writeI32(chunkPos.y);
+    writer.writeI32(chunkPos.z);
+    writer.writeVarU32(static_cast<uint32_t>(edits.size()));
+
+    int32_t lastIndex = 0;
+
+    for (LocalEdit edit : edits) {
+        writer.writeVarU32(static_cast<uint32_t>(edit.index - lastIndex));
+        writer.writeU8(static_cast<uint8_t>(edit.block));
+        lastIndex = edit.index;
+    }
+}
+
+bool EditLog::readBatch(PacketReader& reader, uint32_t& version, glm::ivec3& chunkPos, std::vector<BlockEdit>& edits) {
+    uint32_t editCount;
+
+    if (!reader.readU32(version) || !reader.readI32(chunkPos.x) || !reader.readI32(chunkPos.y) || !reader.readI32(chunkPos.z)) return false;
+    if (!reader.readVarU32(editCount)) return false;
+
+    for (int32_t axis = 0; axis < 3; axis++) {
+        if (chunkPos[axis] < 0 || chunkPos[axis] >= mapSizeInChunks) return false;
+    }
+
+    uint32_t blocksPerChunk = static_cast<uint32_t>(chunkSize * chunkSize * chunkSize);
+    // Edits are unique, so there can't be more of them than blocks.
+    if (editCount > blocksPerChunk) return false;
+
+    glm::ivec3 chunkOrigin = chunkPos * chunkSize;
+    uint32_t index = 0;
+    edits.clear();
+
+    for (uint32_t i = 0; i < editCount; i++) {
+        uint32_t indexOffset;
+        uint8_t block;
+
+        if (!reader.readVarU32(indexOffset) || !reader.readU8(block)) return false;
+        if (block >= blockTypeCount) return false;
+
+        if (indexOffset >= blocksPerChunk - index) return false;
+        index += indexOffset;
+
+        edits.push_back(BlockEdit{
+            chunkOrigin.x + static_cast<int32_t>(index % chunkSize),
+            chunkOrigin.y + static_cast<int32_t>(index / chunkSize % chunkSize),
+            chunkOrigin.z + static_cast<int32_t>(index / (chunkSize * chunkSize)),
+            static_cast<Blocks>(block),
+        });
+    }
+
+    return true;
+}
+
+void EditLog::clear() {
+    for (size_t i = 0; i < editedChunks.size(); i++) {
+        batchIndices[getChunkIndex(editedChunks[i])] = -1;
+        chunkEdits[i].clear();
+    }
+
+    editedChunks.clear();
+}
+
+int32_t EditLog::getChunkIndex(glm::ivec3 chunkPos) {
+    return chunkPos.x + chunkPos.y * mapSizeInChunks + chunkPos.z * mapSizeInChunks * mapSizeInChunks;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "world.hpp"
+#include "protocol.hpp"
+
+// Collects the block edits made during a tick into one batch per chunk, so they're sent and applied together.
+//
+// A batch is written as the chunk's version after the edits, the chunk coordinates and the edit count. Each
+// edit follows as a varint of the distance from the previous edit's block index and then the new block.
+// Edits are sorted by block index, so edits that are close together, like an explosion's, take about two
+// bytes each. Chunks are sent with their version too, which lets clients drop batches that are already
+// part of a chunk they were sent.
+class EditLog {
+public:
+    EditLog(int32_t chunkSize, int32_t mapSizeInChunks);
+    // The block has to be inside of the world.
+    void record(int32_t x, int32_t y, int32_t z, Blocks block);
+    // Chunks with edits since the last clear, in the order they were first edited.
+    const std::vector<glm::ivec3>& getEditedChunks();
+    void writeBatch(glm::ivec3 chunkPos, uint32_t version, PacketWriter& writer);
+    // Read a batch written by writeBatch, with the edits in world coordinates. Returns false if the batch is malformed.
+    bool readBatch(PacketReader& reader, uint32_t& version, glm::ivec3& chunkPos, std::vector<BlockEdit>& edits);
+    void clear();
+
+private:
+    struct LocalEdit {
+        int32_t index;
+        Blocks block;
+    };
+
+    int32_t getChunkIndex(glm::ivec3 chunkPos);
+
+    int32_t chunkSize;
+    int32_t mapSizeInChunks;
+    std::vector<glm::ivec3> editedChunks;
+    // Edits for each chunk in editedChunks, in the order they were made.
+    std::vector<std::vector<LocalEdit>> chunkEdits;
+    // The position of each chunk in editedChunks, or -1 if it hasn't been edited.
+    std::vector<int32_t> batchIndices;
+};
\ No newline at end of file
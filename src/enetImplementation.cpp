@@ -0,0 +1,2 @@
+#define ENET_IMPLEMENTATION
+#include "../deps/enet.h"
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "entities.hpp"
+
+#include <limits>
+
+constexpr uint32_t deadIndex = std::numeric_limits<uint32_t>::max();
+
+EntityId EntityStore::create(glm::vec3 pos, glm::vec3 size) {
+    EntityId id;
+
+    if (freeIds.empty()) {
+        id = static_cast<EntityId>(idToIndex.size());
+        idToIndex.push_back(deadIndex);
+    } else {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+
+    idToIndex[id] = static_cast<uint32_t>(ids.size());
+    ids.push_back(id);
+    positions.push_back(pos);
+    velocities.push_back(glm::vec3(0.0f));
+    sizes.push_back(size);
+    groundedFlags.push_back(false);
+
+    return id;
+}
+
+void EntityStore::destroy(EntityId id) {
+    if (!isAlive(id)) return;
+
+    uint32_t index = idToIndex[id];
+    uint32_t lastIndex = static_cast<uint32_t>(ids.size() - 1);
+
+    // Fill the gap with the last entity to keep the arrays packed.
+    ids[index] = ids[lastIndex];
+    positions[index] = positions[lastIndex];
+    velocities[index] = velocities[lastIndex];
+    sizes[index] = sizes[lastIndex];
+    groundedFlags[index] = groundedFlags[lastIndex];
+    idToIndex[ids[index]] = index;
+
+    ids.pop_back();
+    positions.pop_back();
+    velocities.pop_back();
+    sizes.pop_back();
+    groundedFlags.pop_back();
+
+    idToIndex[id] = deadIndex;
+    freeIds.push_back(id);
+}
+
+bool EntityStore::isAlive(EntityId id) {
+    return id < idToIndex.size() && idToIndex[id] != deadIndex;
+}
+
+uint32_t EntityStore::getIndex(EntityId id) {
+    return idToIndex[id];
+}
+
+size_t EntityStore::getCount() {
+    return ids.size();
+}
+
+std::vector<EntityId>& EntityStore::getIds() {
+    return ids;
+}
+
+std::vector<glm::vec3>& EntityStore::getPositions() {
+    return positions;
+}
+
+std::vector<glm::vec3>& EntityStore::getVelocities() {
+    return velocities;
+}
+
+std::vector<glm::vec3>& EntityStore::getSizes() {
+    return sizes;
+}
+
+std::vector<uint8_t>& EntityStore::getGroundedFlags() {
+    return groundedFlags;
+}
\ No newline at end of file
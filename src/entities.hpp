@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+using EntityId = uint32_t;
+
+// Entities stored as a structure of arrays, each component is packed into its own array so passes that
+// only need a few components don't pull the rest into the cache. Destroying an entity moves the last one
+// into its place, so an entity's index can change but its id won't.
+class EntityStore {
+public:
+    EntityId create(glm::vec3 pos, glm::vec3 size);
+    void destroy(EntityId id);
+    bool isAlive(EntityId id);
+    uint32_t getIndex(EntityId id);
+    size_t getCount();
+
+    std::vector<EntityId>& getIds();
+    std::vector<glm::vec3>& getPositions();
+    std::vector<glm::vec3>& getVelocities();
+    std::vector<glm::vec3>& getSizes();
+    std::vector<uint8_t>& getGroundedFlags();
+
+private:
+    std::vector<EntityId> ids;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> velocities;
+    std::vector<glm::vec3> sizes;
+    std::vector<uint8_t> groundedFlags;
+
+    // Indexed by id, dead ids point past the end of the component arrays.
+    std::vector<uint32_t> idToIndex;
+    std::vector<EntityId> freeIds;
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "entityPhysics.hpp"
+
+#include "world.hpp"
+#include "physics.hpp"
+#include "threadPool.hpp"
+#include "profiler.hpp"
+
+constexpr size_t entityBucketCount = 4096;
+// Entities per batch of work, big enough that scheduling a batch costs much less than running it.
+constexpr size_t entityBatchSize = 256;
+// How quickly overlapping entities accelerate away from each other.
+constexpr float entityPushAcceleration = 20.0f;
+// How quickly entities on the ground slow down.
+constexpr float entityGroundFriction = 10.0f;
+
+EntityPhysics::EntityPhysics(float maxEntitySize, ThreadPool& threadPool)
+    : threadPool(threadPool), spatialHash(maxEntitySize, entityBucketCount) {}
+
+void EntityPhysics::update(EntityStore& entities, World& world, float deltaTime) {
+    PROFILE_ZONE("EntityPhysics::update");
+
+    size_t count = entities.getCount();
+    size_t batchCount = (count + entityBatchSize - 1) / entityBatchSize;
+
+    spatialHash.build(entities);
+    pushes.resize(count);
+    batchNeighbors.resize(batchCount);
+
+    // Every entity finds its own pushes, positions aren't changed until they're all known.
+    threadPool.parallelFor(batchCount, [&](size_t batch) {
+        size_t start = batch * entityBatchSize;
+        findPushes(entities, start, std::min(start + entityBatchSize, count), batchNeighbors[batch], deltaTime);
+    });
+
+    threadPool.parallelFor(batchCount, [&](size_t batch) {
+        size_t start = batch * entityBatchSize;
+        moveEntities(entities, world, start, std::min(start + entityBatchSize, count), deltaTime);
+    });
+}
+
+void EntityPhysics::findPushes(EntityStore& entities, size_t start, size_t end, std::vector<uint32_t>& neighbors, float deltaTime) {
+    PROFILE_ZONE("EntityPhysics::findPushes");
+
+    std::vector<glm::vec3>& positions = entities.getPositions();
+    std::vector<glm::vec3>& sizes = entities.getSizes();
+
+    for (size_t i = start; i < end; i++) {
+        glm::vec3 halfSize = sizes[i] * 0.5f;
+        glm::vec3 push(0.0f);
+
+        neighbors.clear();
+        spatialHash.query(entities, positions[i] - halfSize, positions[i] + halfSize, neighbors);
+
+        for (uint32_t neighbor : neighbors) {
+            if (neighbor == i) continue;
+
+            glm::vec3 offset = positions[i] - positions[neighbor];
+            offset.y = 0.0f;
+
+            float distance = glm::length(offset);
+
+            if (distance > 0.0001f) {
+                push += offset / distance;
+            } else {
+                // Entities that are exactly on top of each other still need to be pushed apart.
+                push.x += neighbor < i ? 1.0f : -1.0f;
+            }
+        }
+
+        pushes[i] = push * entityPushAcceleration * deltaTime;
+    }
+}
+
+// Sweep each entity through the world, one pass over the packed component arrays.
+void EntityPhysics::moveEntities(EntityStore& entities, World& world, size_t start, size_t end, float deltaTime) {
+    PROFILE_ZONE("EntityPhysics::moveEntities");
+
+    std::vector<glm::vec3>& positions = entities.getPositions();
+    std::vector<glm::vec3>& velocities = entities.getVelocities();
+    std::vector<glm::vec3>& sizes = entities.getSizes();
+    std::vector<uint8_t>& groundedFlags = entities.getGroundedFlags();
+
+    // Horizontal movement comes first so entities can slide along the ground.
+    const int32_t axes[3] = {0, 2, 1};
+
+    for (size_t i = start; i < end; i++) {
+        glm::vec3& velocity = velocities[i];
+        velocity += pushes[i];
+        velocity.y -= gravity * deltaTime;
+
+        if (groundedFlags[i]) {
+            float friction = glm::max(1.0f - entityGroundFriction * deltaTime, 0.0f);
+            velocity.x *= friction;
+            velocity.z *= friction;
+        }
+
+        glm::vec3 motion = velocity * deltaTime;
+        bool isGrounded = false;
+
+        for (int32_t axis : axes) {
+            if (motion[axis] == 0.0f) continue;
+
+            glm::vec3 axisMotion(0.0f);
+            axisMotion[axis] = motion[axis];
+
+            SweepHit hit = sweepBox(world, positions[i], sizes[i], axisMotion);
+            positions[i] += axisMotion * hit.time;
+
+            if (hit.hit) {
+                velocity[axis] = 0.0f;
+                isGrounded = isGrounded || hit.normal.y == 1;
+            }
+        }
+
+        groundedFlags[i] = isGrounded;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include "entities.hpp"
+#include "spatialHash.hpp"
+
+class World;
+class ThreadPool;
+
+// Steps every entity in a store on a thread pool. Overlapping entities push each other apart, then each
+// entity is swept through the world one axis at a time, stopping against blocks. The entities are split
+// into batches and each pass runs its batches in parallel, finishing before the next pass starts.
+class EntityPhysics {
+public:
+    // maxEntitySize is the largest width, height or depth of any entity that will be simulated.
+    EntityPhysics(float maxEntitySize, ThreadPool& threadPool);
+    // The world is only read, it can't be edited until this returns.
+    void update(EntityStore& entities, World& world, float deltaTime);
+
+private:
+    void findPushes(EntityStore& entities, size_t start, size_t end, std::vector<uint32_t>& neighbors, float deltaTime);
+    void moveEntities(EntityStore& entities, World& world, size_t start, size_t end, float deltaTime);
+
+    ThreadPool& threadPool;
+    SpatialHash spatialHash;
+    // How much each entity is pushed by its neighbors this tick, applied once every push is known.
+    std::vector<glm::vec3> pushes;
+    // Scratch space for neighbor queries, one per batch.
+    std::vector<std::vector<uint32_t>> batchNeighbors;
+};
\ No newline at end of file
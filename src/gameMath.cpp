@@ -1,7 +1,21 @@
 #include "gameMath.hpp"
 
+// Multiplied as unsigned so large coordinates wrap around instead of overflowing.
 int32_t hashVector(int32_t x, int32_t y, int32_t z) {
-    return x * 73856093 ^ y * 19349663 ^ z * 83492791;
+    uint32_t hash = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u ^ static_cast<uint32_t>(z) * 83492791u;
+    return static_cast<int32_t>(hash);
+}
+
+// Returns a well mixed value in [0, 1] for a position, neighboring positions get unrelated values.
+float hashToUnitFloat(int32_t x, int32_t y, int32_t z) {
+    uint32_t hash = static_cast<uint32_t>(hashVector(x, y, z));
+    hash ^= hash >> 16;
+    hash *= 0x7feb352d;
+    hash ^= hash >> 15;
+    hash *= 0x846ca68b;
+    hash ^= hash >> 16;
+
+    return static_cast<float>(hash & 0xff) / 255.0f;
 }
 
 glm::ivec3 indexTo3d(int32_t i, int32_t size) {
@@ -1,5 +1,2 @@
-#define ENET_IMPLEMENTATION
-#include "../deps/enet.h"
-
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "../deps/tiny_obj_loader.h"
\ No newline at end of file
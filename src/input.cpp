@@ -1,5 +1,7 @@
 #include "input.hpp"
 
+#include "profiler.hpp"
+
 void Input::updateButton(int32_t button, int32_t action, int32_t mods) {
     switch (action) {
     case GLFW_PRESS:
@@ -30,6 +32,8 @@ void Input::updateMousePos(float newMouseX, float newMouseY) {
 }
 
 void Input::update(GLFWwindow* window) {
+    PROFILE_ZONE("Input::update");
+
     if (isFocused && wasButtonPressed(GLFW_KEY_ESCAPE)) {
         // Unfocus the window.
         glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
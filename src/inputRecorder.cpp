@@ -0,0 +1,108 @@
+#include "inputRecorder.hpp"
+
+#include <sstream>
+#include <limits>
+#include <algorithm>
+
+// Recordings are text, one event per line:
+// button <frame> <time> <button> <action>
+// mouse <frame> <time> <x> <y>
+// end <frame>
+
+bool InputRecorder::startRecording(const std::string& path) {
+    recordingFile.open(path);
+    if (!recordingFile) return false;
+
+    // Enough digits for floats to read back exactly.
+    recordingFile.precision(std::numeric_limits<float>::max_digits10);
+    recording = true;
+
+    return true;
+}
+
+bool InputRecorder::startReplay(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) return false;
+
+    std::string line;
+
+    while (std::getline(file, line)) {
+        std::istringstream lineStream(line);
+        std::string type;
+        lineStream >> type;
+
+        InputEvent event{};
+
+        if (type == "button") {
+            event.type = InputEventType::Button;
+            lineStream >> event.frame >> event.time >> event.button >> event.action;
+        } else if (type == "mouse") {
+            event.type = InputEventType::MousePos;
+            lineStream >> event.frame >> event.time >> event.mouseX >> event.mouseY;
+        } else if (type == "end") {
+            lineStream >> replayEndFrame;
+            continue;
+        } else {
+            continue;
+        }
+
+        if (!lineStream) return false;
+
+        replayEvents.push_back(event);
+        replayEndFrame = std::max(replayEndFrame, event.frame);
+    }
+
+    replaying = true;
+
+    return true;
+}
+
+void InputRecorder::stopRecording(uint32_t frame) {
+    if (!recording) return;
+
+    recordingFile << "end " << frame << "\n";
+    recordingFile.close();
+    recording = false;
+}
+
+void InputRecorder::stopReplay() {
+    replaying = false;
+}
+
+bool InputRecorder::isRecording() {
+    return recording;
+}
+
+bool InputRecorder::isReplaying() {
+    return replaying;
+}
+
+bool InputRecorder::isActive() {
+    return recording || replaying;
+}
+
+void InputRecorder::record(InputEvent event) {
+    if (!recording) return;
+
+    switch (event.type) {
+    case InputEventType::Button:
+        recordingFile << "button " << event.frame << " " << event.time << " " << event.button << " " << event.action << "\n";
+        break;
+    case InputEventType::MousePos:
+        recordingFile << "mouse " << event.frame << " " << event.time << " " << event.mouseX << " " << event.mouseY << "\n";
+        break;
+    }
+}
+
+bool InputRecorder::getNextEvent(uint32_t frame, InputEvent& event) {
+    if (nextReplayEvent >= replayEvents.size() || replayEvents[nextReplayEvent].frame > frame) return false;
+
+    event = replayEvents[nextReplayEvent];
+    nextReplayEvent++;
+
+    return true;
+}
+
+bool InputRecorder::isReplayFinished(uint32_t frame) {
+    return replaying && frame >= replayEndFrame;
+}
\ No newline at end of file
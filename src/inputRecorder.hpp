@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cinttypes>
+#include <string>
+#include <vector>
+#include <fstream>
+
+enum class InputEventType {
+    Button,
+    MousePos,
+};
+
+// An input event, tagged with the frame that it was applied before and the time since recording started.
+struct InputEvent {
+    InputEventType type;
+    uint32_t frame;
+    float time;
+    int32_t button;
+    int32_t action;
+    float mouseX;
+    float mouseY;
+};
+
+// Saves input events to a file while recording, and reads them back for replays. Recording and
+// replaying both use a fixed time step, so a replay runs the same simulation as the recording did.
+class InputRecorder {
+public:
+    bool startRecording(const std::string& path);
+    bool startReplay(const std::string& path);
+    void stopRecording(uint32_t frame);
+    void stopReplay();
+    bool isRecording();
+    bool isReplaying();
+    bool isActive();
+    void record(InputEvent event);
+    // Get the next event that should be applied before the given frame, in the order they were recorded.
+    bool getNextEvent(uint32_t frame, InputEvent& event);
+    bool isReplayFinished(uint32_t frame);
+
+private:
+    bool recording = false;
+    bool replaying = false;
+    std::ofstream recordingFile;
+
+    std::vector<InputEvent> replayEvents;
+    size_t nextReplayEvent = 0;
+    uint32_t replayEndFrame = 0;
+};
\ No newline at end of file
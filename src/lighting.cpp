@@ -0,0 +1,203 @@
+#include "lighting.hpp"
+
+#include <cassert>
+
+#include "world.hpp"
+#include "directions.hpp"
+#include "profiler.hpp"
+
+// Full strength sky light falls straight down without getting dimmer.
+static bool isSkyLightFalling(LightChannel channel, int32_t face, uint8_t level) {
+    return channel == LightChannel::Sky && directions[face][1] == -1 && level == maxLightLevel;
+}
+
+// Light a chunk column along with the light it spreads into the surrounding columns. Light fades out
+// before it can cross a whole chunk, so nothing past the surrounding columns is read or written.
+void LightEngine::lightColumn(World& world, int32_t chunkX, int32_t chunkZ) {
+    PROFILE_ZONE("LightEngine::lightColumn");
+
+    int32_t chunkSize = world.getChunkSize();
+    // Light has to fade out within one chunk, otherwise the edge of the neighborhood would cut it off.
+    assert(chunkSize >= maxLightLevel + 1);
+
+    seedColumn(world, LightBounds{
+        chunkX * chunkSize,
+        chunkZ * chunkSize,
+        (chunkX + 1) * chunkSize,
+        (chunkZ + 1) * chunkSize,
+    });
+
+    LightBounds neighborhood{
+        (chunkX - 1) * chunkSize,
+        (chunkZ - 1) * chunkSize,
+        (chunkX + 2) * chunkSize,
+        (chunkZ + 2) * chunkSize,
+    };
+
+    for (LightChannel channel : lightChannels) {
+        std::vector<LightNode>& channelSpilledLight = spilledLight[static_cast<size_t>(channel)];
+
+        for (LightNode node : channelSpilledLight) {
+            if (world.isBlockOccupied(node.x, node.y, node.z)) continue;
+            if (world.getLight(node.x, node.y, node.z, channel) >= node.level) continue;
+
+            world.setLight(node.x, node.y, node.z, channel, node.level);
+            addQueue.push(node);
+        }
+
+        channelSpilledLight.clear();
+        propagateLight(world, channel, neighborhood);
+        channelSpilledLight.clear();
+    }
+}
+
+// Light a column, keeping any light that would leave it in spilledLight.
+void LightEngine::seedColumn(World& world, LightBounds bounds) {
+    int32_t mapSize = world.getMapSize();
+
+    // Sky light shines down each column until it hits a block.
+    for (int32_t z = bounds.minZ; z < bounds.maxZ; z++) {
+        for (int32_t x = bounds.minX; x < bounds.maxX; x++) {
+            for (int32_t y = mapSize - 1; y >= 0; y--) {
+                if (world.isBlockOccupied(x, y, z)) break;
+
+                world.setLight(x, y, z, LightChannel::Sky, maxLightLevel);
+                addQueue.push(LightNode{x, y, z, maxLightLevel});
+            }
+        }
+    }
+
+    propagateLight(world, LightChannel::Sky, bounds);
+
+    for (int32_t z = bounds.minZ; z < bounds.maxZ; z++) {
+        for (int32_t y = 0; y < mapSize; y++) {
+            for (int32_t x = bounds.minX; x < bounds.maxX; x++) {
+                uint8_t emission = blockLightEmission[static_cast<size_t>(world.getBlock(x, y, z))];
+                if (emission == 0) continue;
+
+                world.setLight(x, y, z, LightChannel::Block, emission);
+                addQueue.push(LightNode{x, y, z, emission});
+            }
+        }
+    }
+
+    propagateLight(world, LightChannel::Block, bounds);
+}
+
+// Relight the area around a block that was just changed, only cells that
+// were lit through the changed block are visited.
+void LightEngine::updateBlock(World& world, int32_t x, int32_t y, int32_t z, Blocks block) {
+    PROFILE_ZONE("LightEngine::updateBlock");
+
+    for (LightChannel channel : lightChannels) {
+        uint8_t oldLevel = world.getLight(x, y, z, channel);
+
+        if (oldLevel > 0) {
+            world.setLight(x, y, z, channel, 0);
+            removeQueue.push(LightNode{x, y, z, oldLevel});
+            removeLight(world, channel);
+        }
+
+        if (block == Blocks::Air) {
+            // Let the surrounding light flow back into the block.
+            for (int32_t face = 0; face < 6; face++) {
+                int32_t neighborX = x + directions[face][0];
+                int32_t neighborY = y + directions[face][1];
+                int32_t neighborZ = z + directions[face][2];
+                uint8_t neighborLevel = world.getLight(neighborX, neighborY, neighborZ, channel);
+
+                if (neighborLevel > 0) {
+                    addQueue.push(LightNode{neighborX, neighborY, neighborZ, neighborLevel});
+                }
+            }
+
+            if (channel == LightChannel::Sky && y == world.getMapSize() - 1) {
+                world.setLight(x, y, z, channel, maxLightLevel);
+                addQueue.push(LightNode{x, y, z, maxLightLevel});
+            }
+        }
+
+        uint8_t emission = blockLightEmission[static_cast<size_t>(block)];
+        if (channel == LightChannel::Block && emission > 0) {
+            world.setLight(x, y, z, channel, emission);
+            addQueue.push(LightNode{x, y, z, emission});
+        }
+
+        propagateLight(world, channel, getWorldBounds(world));
+        // Anything that spilled is outside of the world.
+        spilledLight[static_cast<size_t>(channel)].clear();
+    }
+}
+
+void LightEngine::removeLight(World& world, LightChannel channel) {
+    while (!removeQueue.empty()) {
+        LightNode node = removeQueue.front();
+        removeQueue.pop();
+
+        for (int32_t face = 0; face < 6; face++) {
+            int32_t neighborX = node.x + directions[face][0];
+            int32_t neighborY = node.y + directions[face][1];
+            int32_t neighborZ = node.z + directions[face][2];
+            uint8_t neighborLevel = world.getLight(neighborX, neighborY, neighborZ, channel);
+
+            if (neighborLevel == 0) continue;
+
+            // Neighbors that are at least as bright as the removed light have another source,
+            // so they are used to fill the removed area back in.
+            if (neighborLevel >= node.level && !isSkyLightFalling(channel, face, node.level)) {
+                addQueue.push(LightNode{neighborX, neighborY, neighborZ, neighborLevel});
+                continue;
+            }
+
+            world.setLight(neighborX, neighborY, neighborZ, channel, 0);
+            removeQueue.push(LightNode{neighborX, neighborY, neighborZ, neighborLevel});
+
+            if (channel == LightChannel::Block) {
+                Blocks neighborBlock = world.getBlock(neighborX, neighborY, neighborZ);
+                uint8_t emission = blockLightEmission[static_cast<size_t>(neighborBlock)];
+
+                if (emission > 0) {
+                    world.setLight(neighborX, neighborY, neighborZ, channel, emission);
+                    addQueue.push(LightNode{neighborX, neighborY, neighborZ, emission});
+                }
+            }
+        }
+    }
+}
+
+void LightEngine::propagateLight(World& world, LightChannel channel, LightBounds bounds) {
+    while (!addQueue.empty()) {
+        LightNode node = addQueue.front();
+        addQueue.pop();
+
+        // The node's light may have changed since it was queued, so spread whatever it has now.
+        uint8_t level = world.getLight(node.x, node.y, node.z, channel);
+        if (level == 0) continue;
+
+        for (int32_t face = 0; face < 6; face++) {
+            int32_t neighborX = node.x + directions[face][0];
+            int32_t neighborY = node.y + directions[face][1];
+            int32_t neighborZ = node.z + directions[face][2];
+
+            uint8_t newLevel = isSkyLightFalling(channel, face, level) ? level : level - 1;
+
+            // Blocks outside the bounds aren't read, whoever takes the spilled light checks them.
+            if (neighborX < bounds.minX || neighborX >= bounds.maxX || neighborZ < bounds.minZ || neighborZ >= bounds.maxZ) {
+                spilledLight[static_cast<size_t>(channel)].push_back(LightNode{neighborX, neighborY, neighborZ, newLevel});
+                continue;
+            }
+
+            if (world.isBlockOccupied(neighborX, neighborY, neighborZ)) continue;
+
+            if (world.getLight(neighborX, neighborY, neighborZ, channel) >= newLevel) continue;
+
+            world.setLight(neighborX, neighborY, neighborZ, channel, newLevel);
+            addQueue.push(LightNode{neighborX, neighborY, neighborZ, newLevel});
+        }
+    }
+}
+
+LightBounds LightEngine::getWorldBounds(World& world) {
+    int32_t mapSize = world.getMapSize();
+    return LightBounds{0, 0, mapSize, mapSize};
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cinttypes>
+#include <array>
+#include <queue>
+#include <vector>
+
+#include "blocks.hpp"
+
+class World;
+
+constexpr uint8_t maxLightLevel = 15;
+
+enum class LightChannel {
+    Sky,
+    Block,
+};
+
+const std::array<LightChannel, 2> lightChannels = {
+    LightChannel::Sky,
+    LightChannel::Block,
+};
+
+// How much block light each block type gives off, indexed by Blocks.
+const std::array<uint8_t, 3> blockLightEmission = {
+    0, // Air
+    0, // Dirt
+    0, // Stone
+};
+
+struct LightNode {
+    int32_t x, y, z;
+    uint8_t level;
+};
+
+// The horizontal area that light is allowed to spread through, max is exclusive.
+struct LightBounds {
+    int32_t minX, minZ;
+    int32_t maxX, maxZ;
+};
+
+// Flood-fill lighting, light levels fall off by one for each block travelled.
+class LightEngine {
+public:
+    void lightColumn(World& world, int32_t chunkX, int32_t chunkZ);
+    void updateBlock(World& world, int32_t x, int32_t y, int32_t z, Blocks block);
+
+private:
+    void seedColumn(World& world, LightBounds bounds);
+    void removeLight(World& world, LightChannel channel);
+    void propagateLight(World& world, LightChannel channel, LightBounds bounds);
+    LightBounds getWorldBounds(World& world);
+
+    std::queue<LightNode> addQueue;
+    std::queue<LightNode> removeQueue;
+    // Light that would have spread outside of the bounds it was propagated in, one list per channel.
+    std::array<std::vector<LightNode>, 2> spilledLight;
+};
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <random>
 #include <thread>
+#include <iostream>
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -23,12 +24,29 @@
 #include "primitiveMeshes.hpp"
 #include "frustum.hpp"
 #include "input.hpp"
+#include "threadPool.hpp"
+#include "worldGenerator.hpp"
+#include "worldRenderer.hpp"
+#include "blockInteractionRenderer.hpp"
+#include "profiler.hpp"
+#include "stats.hpp"
+#include "inputRecorder.hpp"
 
 constexpr int32_t chunkSize = 32;
 constexpr int32_t mapSizeInChunks = 4;
 constexpr int32_t chunkCount = mapSizeInChunks * mapSizeInChunks * mapSizeInChunks;
 constexpr float fogMaxDistance = 64.0f;
 constexpr float mouseSensitivity = 0.1f;
+constexpr const char* profilerTracePath = "profile.json";
+// How often stats are written, leave the path empty to write them to stdout.
+constexpr float statsInterval = 5.0f;
+constexpr const char* statsPath = "";
+// The simulation runs at a fixed rate, frames are rendered in between the last two ticks.
+constexpr float simulationTimeStep = 1.0f / 60.0f;
+// Longer frames are clamped, so the simulation slows down instead of running a burst of ticks to catch up.
+constexpr float maxFrameTime = 0.25f;
+// Set interpolateNoise to false to sample the terrain noise at every block.
+constexpr TerrainSettings terrainSettings{true, 4};
 
 class App {
 private:
@@ -57,21 +75,35 @@ private:
     GLFWwindow* window;
     float windowWidth, windowHeight;
     float currentTime = 0;
+    float initStartTime = 0;
 
     Frustum frustum;
     World world;
+    WorldRenderer worldRenderer;
     Player player;
     BlockInteraction blockInteraction;
+    BlockInteractionRenderer blockInteractionRenderer;
     Model<VertexData, uint16_t, InstanceData> crosshair;
     Model<VertexData, uint32_t, InstanceData> model;
 
     Input input;
+    StatsReporter statsReporter;
+    InputRecorder inputRecorder;
+    uint32_t simulationTick = 0;
+    float tickAccumulator = 0;
+    float tickInterpolation = 0;
+    float replayStartTime = 0;
+    ThreadPool threadPool;
+    WorldGenerator worldGenerator;
+
+    glm::ivec3 playerSpawnChunk;
+    bool isPlayerSpawned = false;
 
     bool updateWorld = true;
     std::thread worldUpdateThread;
 
 public:
-    App() : world(chunkSize, mapSizeInChunks) {}
+    App() : world(chunkSize, mapSizeInChunks), statsReporter(statsInterval, statsPath), worldGenerator(world, threadPool) {}
 
     void loadObjData(const std::string& path, const std::string& file, std::vector<VertexData>& vertices,
         std::vector<uint32_t>& indices, std::vector<std::string>& textures) {
@@ -134,21 +166,66 @@ public:
         }
     }
 
+    bool recordInput(const std::string& path) {
+        return inputRecorder.startRecording(path);
+    }
+
+    bool replayInput(const std::string& path) {
+        return inputRecorder.startReplay(path);
+    }
+
     void updateMousePos(float newMouseX, float newMouseY) {
-        input.updateMousePos(newMouseX, newMouseY);
-        glm::vec2 delta = input.getMouseDelta();
-        player.updateRotation(delta.x, delta.y);
+        // Replays only use recorded input.
+        if (inputRecorder.isReplaying()) return;
+
+        inputRecorder.record(InputEvent{InputEventType::MousePos, simulationTick, getInputTime(), 0, 0, newMouseX, newMouseY});
+        applyMousePos(newMouseX, newMouseY);
     }
 
     void updateKey(int32_t key, int32_t scancode, int32_t action, int32_t mods) {
-        input.updateButton(key, action, mods);
+        updateButton(key, action, mods);
     }
 
     void updateMouseButton(int32_t button, int32_t action, int32_t mods) {
+        updateButton(button, action, mods);
+    }
+
+    void updateButton(int32_t button, int32_t action, int32_t mods) {
+        if (inputRecorder.isReplaying()) return;
+
+        inputRecorder.record(InputEvent{InputEventType::Button, simulationTick, getInputTime(), button, action, 0.0f, 0.0f});
         input.updateButton(button, action, mods);
     }
 
+    void applyMousePos(float newMouseX, float newMouseY) {
+        input.updateMousePos(newMouseX, newMouseY);
+        glm::vec2 delta = input.getMouseDelta();
+        player.updateRotation(delta.x, delta.y);
+    }
+
+    void applyReplayedInput() {
+        InputEvent event;
+
+        while (inputRecorder.getNextEvent(simulationTick, event)) {
+            switch (event.type) {
+            case InputEventType::Button:
+                input.updateButton(event.button, event.action, 0);
+                break;
+            case InputEventType::MousePos:
+                applyMousePos(event.mouseX, event.mouseY);
+                break;
+            }
+        }
+    }
+
+    float getInputTime() {
+        return static_cast<float>(glfwGetTime()) - initStartTime;
+    }
+
     void init(VulkanState& vulkanState, GLFWwindow* window, int32_t width, int32_t height) {
+        initStartTime = static_cast<float>(glfwGetTime());
+        setProfilerThreadName("Main");
+
         windowWidth = static_cast<float>(width);
         windowHeight = static_cast<float>(height);
         this->window = window;
@@ -292,7 +369,7 @@ public:
                                        static_cast<uint32_t>(descriptorWrites.size()),
                                        descriptorWrites.data(), 0, nullptr);
             });
-        pipeline.create<VertexData, InstanceData>(
+        pipeline.create<VertexDataLayout, InstanceDataLayout>(
             "res/cubesShader.vert.spv", "res/cubesShader.frag.spv", vulkanState.device, renderPass, false);
 
         std::vector<VertexData> modelVertices;
@@ -399,7 +476,7 @@ public:
                                        static_cast<uint32_t>(descriptorWrites.size()),
                                        descriptorWrites.data(), 0, nullptr);
             });
-        modelPipeline.create<VertexData, InstanceData>(
+        modelPipeline.create<VertexDataLayout, InstanceDataLayout>(
             "res/modelShader.vert.spv", "res/modelShader.frag.spv", vulkanState.device, renderPass, false);
 
         transparentPipeline.createDescriptorSetLayout(
@@ -466,7 +543,7 @@ public:
                                        static_cast<uint32_t>(descriptorWrites.size()),
                                        descriptorWrites.data(), 0, nullptr);
             });
-        transparentPipeline.create<TransparentVertexData, InstanceData>(
+        transparentPipeline.create<TransparentVertexDataLayout, InstanceDataLayout>(
             "res/transparentShader.vert.spv", "res/transparentShader.frag.spv", vulkanState.device, renderPass, true);
 
         uiPipeline.createDescriptorSetLayout(
@@ -533,7 +610,7 @@ public:
                                        static_cast<uint32_t>(descriptorWrites.size()),
                                        descriptorWrites.data(), 0, nullptr);
             });
-        uiPipeline.create<VertexData, InstanceData>(
+        uiPipeline.create<VertexDataLayout, InstanceDataLayout>(
             "res/uiShader.vert.spv", "res/uiShader.frag.spv", vulkanState.device, renderPass, true);
 
         clearValues.resize(2);
@@ -545,16 +622,23 @@ public:
         std::mt19937 rng{seed};
         siv::BasicPerlinNoise<float> noise{seed};
 
-        world.generate(rng, noise);
-
         int32_t playerSpawnI = rng() % chunkCount;
-        glm::ivec3 playerSpawnChunk = indexTo3d(playerSpawnI, mapSizeInChunks);
-        glm::vec3 playerSpawnPos = world.getSpawnPos(playerSpawnChunk.x, playerSpawnChunk.y, playerSpawnChunk.z, true).value();
-        player.setPos(playerSpawnPos);
+        playerSpawnChunk = indexTo3d(playerSpawnI, mapSizeInChunks);
 
-        blockInteraction.init(vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue, vulkanState.device);
+        // The world generates in the background, starting around the player so they can spawn
+        // before the rest of the map is done.
+        worldGenerator.start(noise, terrainSettings, playerSpawnChunk.x, playerSpawnChunk.z);
+
+        // Spawning has to happen on the same tick in recordings and their replays.
+        if (inputRecorder.isActive()) {
+            worldGenerator.wait();
+        }
+        player.teleport(glm::vec3(playerSpawnChunk * chunkSize) + glm::vec3(chunkSize * 0.5f));
+
+        blockInteractionRenderer.init(vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue, vulkanState.device);
 
         currentTime = static_cast<float>(glfwGetTime());
+        replayStartTime = currentTime;
 
         std::vector<VertexData> crosshairVertices;
         size_t vertexCount = crosshairVertices.size();
@@ -579,41 +663,118 @@ public:
         fogUbo.update(FogUniformData{glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), fogMaxDistance});
 
         worldUpdateThread = std::thread([&]() {
+            setProfilerThreadName("World update");
+
             while (updateWorld) {
-                world.update(vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue, vulkanState.device);
+                world.update();
             }
         });
     }
 
     void update(VulkanState& vulkanState) {
+        PROFILE_ZONE("App::update");
+
         float newTime = static_cast<float>(glfwGetTime());
         float deltaTime = newTime - currentTime;
         currentTime = newTime;
 
-        // Ignore outlier deltaTime values to prevent the simulation from moving too fast.
-        if (deltaTime > 0.1f) {
+        recordHistogram(Histogram::FrameTime, deltaTime * 1000.0f);
+        statsReporter.update(currentTime);
+
+        if (inputRecorder.isReplaying()) {
+            // Replays run a tick every frame, as fast as frames can be drawn.
+            tick();
+            tickInterpolation = 1.0f;
+        } else {
+            tickAccumulator += std::min(deltaTime, maxFrameTime);
+
+            while (tickAccumulator >= simulationTimeStep) {
+                tick();
+                tickAccumulator -= simulationTimeStep;
+            }
+
+            tickInterpolation = tickAccumulator / simulationTimeStep;
+        }
+
+        worldRenderer.upload(world, vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue, vulkanState.device);
+        blockInteractionRenderer.upload(blockInteraction, vulkanState.commands, vulkanState.allocator, vulkanState.graphicsQueue, vulkanState.device);
+    }
+
+    // Advance the simulation by simulationTimeStep.
+    void tick() {
+        PROFILE_ZONE("App::tick");
+
+        if (inputRecorder.isReplayFinished(simulationTick)) {
+            finishReplay();
             return;
         }
 
+        if (inputRecorder.isReplaying()) {
+            applyReplayedInput();
+        }
+
+#ifdef MPVOXELS_PROFILER
+        if (input.wasButtonPressed(GLFW_KEY_F3)) {
+            writeTrace();
+        }
+#endif
+
         blockInteraction.preUpdate();
 
-        world.upload(vulkanState.allocator, vulkanState.commands, vulkanState.graphicsQueue, vulkanState.device);
+        if (!isPlayerSpawned) {
+            trySpawnPlayer();
+        }
 
-        player.updateMovement(input, world, deltaTime);
-        player.updateInteraction(input, world, blockInteraction, deltaTime);
+        if (isPlayerSpawned) {
+            player.updateMovement(input, world, simulationTimeStep);
+            player.updateInteraction(input, world, worldGenerator, blockInteraction, simulationTimeStep);
+        }
 
-        blockInteraction.postUpdate(vulkanState.commands, vulkanState.allocator, vulkanState.graphicsQueue, vulkanState.device);
+        blockInteraction.postUpdate();
 
         input.update(window);
+        simulationTick++;
+    }
+
+    void finishReplay() {
+        float replayTime = currentTime - replayStartTime;
+        std::cout << "Replayed " << simulationTick << " ticks in " << replayTime << "s, "
+                  << replayTime * 1000.0f / std::max(simulationTick, 1u) << "ms per tick\n";
+
+        inputRecorder.stopReplay();
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+    }
+
+    // Spawn the player once the chunks around them are generated and can be edited.
+    void trySpawnPlayer() {
+        if (!worldGenerator.isAreaGenerated(playerSpawnChunk.x, playerSpawnChunk.z, editableAreaRadius)) return;
+
+        glm::vec3 playerSpawnPos = world.getSpawnPos(playerSpawnChunk.x, playerSpawnChunk.y, playerSpawnChunk.z, true).value();
+        player.teleport(playerSpawnPos);
+        isPlayerSpawned = true;
+
+        std::cout << "Time to first interactive frame: " << (currentTime - initStartTime) * 1000.0f << "ms\n";
     }
 
+#ifdef MPVOXELS_PROFILER
+    void writeTrace() {
+        if (writeProfilerTrace(profilerTracePath)) {
+            std::cout << "Wrote profiler trace to " << profilerTracePath << "\n";
+        } else {
+            std::cerr << "Failed to write profiler trace to " << profilerTracePath << "\n";
+        }
+    }
+#endif
+
     void render(VulkanState& vulkanState, VkCommandBuffer commandBuffer, uint32_t imageIndex,
                 uint32_t currentFrame) {
+        PROFILE_ZONE("App::render");
+
         const VkExtent2D& extent = vulkanState.swapchain.getExtent();
 
         UniformBufferData uboData{};
         uboData.model = glm::mat4(1.0f);
-        uboData.view = player.getViewMatrix();
+        uboData.view = player.getViewMatrix(tickInterpolation);
         uboData.proj = glm::perspective(glm::radians(player.getFov()), extent.width / (float)extent.height, 0.1f, fogMaxDistance);
         uboData.proj[1][1] *= -1;
 
@@ -630,16 +791,18 @@ public:
 
         renderPass.begin(imageIndex, commandBuffer, extent, clearValues);
         pipeline.bind(commandBuffer, currentFrame);
-        world.draw(frustum, commandBuffer);
+        worldRenderer.draw(world, frustum, commandBuffer);
 
         transparentPipeline.bind(commandBuffer, currentFrame);
-        blockInteraction.draw(commandBuffer);
+        blockInteractionRenderer.draw(commandBuffer);
 
         modelPipeline.bind(commandBuffer, currentFrame);
         model.draw(commandBuffer);
+        addCounter(Counter::DrawCalls);
 
         uiPipeline.bind(commandBuffer, currentFrame);
         crosshair.draw(commandBuffer);
+        addCounter(Counter::DrawCalls);
 
         renderPass.end(commandBuffer);
 
@@ -655,9 +818,15 @@ public:
     }
 
     void cleanup(VulkanState& vulkanState) {
+        inputRecorder.stopRecording(simulationTick);
+        worldGenerator.stop();
         updateWorld = false;
         worldUpdateThread.join();
 
+#ifdef MPVOXELS_PROFILER
+        writeTrace();
+#endif
+
         pipeline.cleanup(vulkanState.device);
         modelPipeline.cleanup(vulkanState.device);
         transparentPipeline.cleanup(vulkanState.device);
@@ -675,8 +844,8 @@ public:
         vkDestroyImageView(vulkanState.device, uiTextureImageView, nullptr);
         uiTextureImage.destroy(vulkanState.allocator);
 
-        world.destroy(vulkanState.allocator);
-        blockInteraction.destroy(vulkanState.allocator);
+        worldRenderer.destroy(vulkanState.allocator);
+        blockInteractionRenderer.destroy(vulkanState.allocator);
         crosshair.destroy(vulkanState.allocator);
 
         vkDestroySampler(vulkanState.device, modelTextureSampler, nullptr);
@@ -724,7 +893,21 @@ public:
     }
 };
 
-int main() {
+// Pass --record <path> to save this session's input, or --replay <path> to play a recording back.
+int main(int argc, char** argv) {
     App app;
+
+    if (argc == 3 && std::string(argv[1]) == "--record") {
+        if (!app.recordInput(argv[2])) {
+            std::cerr << "Failed to open " << argv[2] << " for recording\n";
+            return EXIT_FAILURE;
+        }
+    } else if (argc == 3 && std::string(argv[1]) == "--replay") {
+        if (!app.replayInput(argv[2])) {
+            std::cerr << "Failed to read the recording " << argv[2] << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
     return app.run();
 }
\ No newline at end of file
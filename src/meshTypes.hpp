@@ -0,0 +1,21 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Vertex formats that meshes are built in on the CPU, the renderer describes
+// their layouts to the GPU in renderTypes.hpp.
+
+struct VertexData {
+    glm::vec3 pos;
+    glm::vec3 color;
+    glm::vec3 texCoord;
+};
+
+struct TransparentVertexData {
+    alignas(16) glm::vec3 pos;
+    alignas(16) glm::vec4 color;
+};
+
+struct InstanceData {
+    glm::vec3 pos;
+};
\ No newline at end of file
@@ -1,37 +1,133 @@
 #include "physics.hpp"
 
+#include <limits>
+#include <utility>
+
+#include "profiler.hpp"
+
 bool isCollidingWithBlock(World& world, glm::vec3 pos, glm::vec3 size) {
     return getBlockCollision(world, pos, size).has_value();
 }
 
+// Boxes stop this far away from the blocks they hit, so rounding can't leave them inside of a block.
+constexpr float collisionSkin = 0.001f;
+// Edges closer to a block boundary than this count as being on it.
+constexpr float boundaryTolerance = 0.0001f;
+
+// The blocks a box overlaps, touching a block doesn't count. maxBlock is inclusive.
+static void getOverlappedBlocks(glm::vec3 min, glm::vec3 max, glm::ivec3& minBlock, glm::ivec3& maxBlock) {
+    minBlock = floorToInt(min);
+    maxBlock = floorToInt(glm::ceil(max)) - 1;
+}
+
 std::optional<glm::ivec3> getBlockCollision(World& world, glm::vec3 pos, glm::vec3 size) {
     // The position supplied is the center of the bounding box.
-    glm::vec3 pos0 = pos - size * 0.5f;
-    glm::vec3 pos1 = pos + size * 0.5f;
+    glm::ivec3 minBlock, maxBlock;
+    getOverlappedBlocks(pos - size * 0.5f, pos + size * 0.5f, minBlock, maxBlock);
+
+    for (int32_t y = minBlock.y; y <= maxBlock.y; y++) {
+        for (int32_t z = minBlock.z; z <= maxBlock.z; z++) {
+            for (int32_t x = minBlock.x; x <= maxBlock.x; x++) {
+                if (world.isBlockOccupied(x, y, z)) {
+                    return std::optional<glm::ivec3>{glm::ivec3(x, y, z)};
+                }
+            }
+        }
+    }
+
+    return std::nullopt;
+}
 
-    glm::ivec3 steps = floorToInt(size) + 1;
-    glm::vec3 interp;
+// Move a box along motion until it touches a block. Only the layer of blocks the box's leading face
+// moves into is checked each time it crosses a block boundary, so fast boxes can't tunnel through
+// walls. Blocks that the box already overlaps at the start are ignored, letting it move out of them.
+SweepHit sweepBox(World& world, glm::vec3 pos, glm::vec3 size, glm::vec3 motion) {
+    float length = glm::length(motion);
 
-    // Interpolate between pos0 and pos1, checking each block between them.
-    for (int32_t x = 0; x <= steps.x; x++) {
-        interp.x = pos0.x + (static_cast<float>(x) / steps.x) * size.x;
+    if (length == 0.0f) {
+        return SweepHit{false, 1.0f, glm::ivec3(0), glm::ivec3(0)};
+    }
+
+    glm::vec3 dir = motion / length;
+    glm::vec3 min = pos - size * 0.5f;
+    glm::vec3 max = pos + size * 0.5f;
+
+    glm::ivec3 step;
+    // The blocks the box overlaps on each axis, leadBlock is on the side it moves towards.
+    glm::ivec3 leadBlock, trailBlock;
+    glm::vec3 distToNext;
+    glm::vec3 distBetween;
+
+    getOverlappedBlocks(min, max, trailBlock, leadBlock);
 
-        for (int32_t y = 0; y <= steps.y; y++) {
-            interp.y = pos0.y + (static_cast<float>(y) / steps.y) * size.y;
+    for (int32_t axis = 0; axis < 3; axis++) {
+        if (dir[axis] > 0.0f) {
+            step[axis] = 1;
+            leadBlock[axis] = floorToInt(glm::ceil(max[axis] - boundaryTolerance)) - 1;
+            distBetween[axis] = 1.0f / dir[axis];
+            distToNext[axis] = glm::max(static_cast<float>(leadBlock[axis] + 1) - max[axis], 0.0f) * distBetween[axis];
+        } else if (dir[axis] < 0.0f) {
+            step[axis] = -1;
+            std::swap(leadBlock[axis], trailBlock[axis]);
+            leadBlock[axis] = floorToInt(min[axis] + boundaryTolerance);
+            distBetween[axis] = -1.0f / dir[axis];
+            distToNext[axis] = glm::max(min[axis] - static_cast<float>(leadBlock[axis]), 0.0f) * distBetween[axis];
+        } else {
+            step[axis] = 0;
+            distBetween[axis] = 0.0f;
+            distToNext[axis] = std::numeric_limits<float>::infinity();
+        }
+    }
 
-            for (int32_t z = 0; z <= steps.z; z++) {
-                interp.z = pos0.z + (static_cast<float>(z) / steps.z) * size.z;
+    while (true) {
+        int32_t axis = 0;
 
-                glm::ivec3 interpBlock = floorToInt(interp);
+        if (distToNext.y < distToNext[axis]) axis = 1;
+        if (distToNext.z < distToNext[axis]) axis = 2;
 
-                if (world.isBlockOccupied(interpBlock.x, interpBlock.y, interpBlock.z)) {
-                    return std::optional<glm::ivec3>{interpBlock};
+        float dist = distToNext[axis];
+        if (dist > length) break;
+
+        leadBlock[axis] += step[axis];
+        distToNext[axis] += distBetween[axis];
+
+        // The trailing face moves too, so the blocks it left behind aren't checked.
+        glm::vec3 movedMin = min + dir * dist;
+        glm::vec3 movedMax = max + dir * dist;
+
+        for (int32_t other = 0; other < 3; other++) {
+            if (other == axis || step[other] == 0) continue;
+
+            if (step[other] > 0) {
+                trailBlock[other] = floorToInt(movedMin[other] + boundaryTolerance);
+            } else {
+                trailBlock[other] = floorToInt(glm::ceil(movedMax[other] - boundaryTolerance)) - 1;
+            }
+        }
+
+        // The layer of blocks that the leading face just moved into.
+        glm::ivec3 minBlock = glm::min(leadBlock, trailBlock);
+        glm::ivec3 maxBlock = glm::max(leadBlock, trailBlock);
+        minBlock[axis] = leadBlock[axis];
+        maxBlock[axis] = leadBlock[axis];
+
+        for (int32_t y = minBlock.y; y <= maxBlock.y; y++) {
+            for (int32_t z = minBlock.z; z <= maxBlock.z; z++) {
+                for (int32_t x = minBlock.x; x <= maxBlock.x; x++) {
+                    if (!world.isBlockOccupied(x, y, z)) continue;
+
+                    glm::ivec3 normal(0);
+                    normal[axis] = -step[axis];
+                    // Back off along the hit axis by the skin width.
+                    float hitDist = glm::max(dist - collisionSkin * distBetween[axis], 0.0f);
+
+                    return SweepHit{true, hitDist / length, normal, glm::ivec3(x, y, z)};
                 }
             }
         }
     }
 
-    return std::nullopt;
+    return SweepHit{false, 1.0f, glm::ivec3(0), glm::ivec3(0)};
 }
 
 bool overlapsBlock(float x, glm::vec3 pos, glm::vec3 size, glm::ivec3 blockPos) {
@@ -51,7 +147,66 @@ bool isOnGround(World& world, glm::vec3 pos, glm::vec3 size) {
     return isCollidingWithBlock(world, feetPos, feetSize);
 }
 
-RaycastHit raycast(World& world, glm::vec3 start, glm::vec3 dir, float range) {
+// Move a ray to the first block past the empty cube of the given size that blockPos is in. Returns false
+// without moving the ray if that block is out of range, the last few blocks are stepped through one at a
+// time so that rays stop in the same place as they would without skipping.
+static bool skipEmptySpace(glm::vec3 start, glm::vec3 dir, float range, glm::vec3 step, glm::ivec3 tileDir,
+    int32_t emptySpaceSize, glm::ivec3& blockPos, glm::ivec3& lastPos, glm::vec3& distToNext, float& lastDistToNext) {
+
+    glm::ivec3 spaceMin = (blockPos / emptySpaceSize) * emptySpaceSize;
+    float exitDist = std::numeric_limits<float>::infinity();
+    int32_t exitAxis = 0;
+
+    for (int32_t axis = 0; axis < 3; axis++) {
+        float axisExitDist;
+
+        if (dir[axis] > 0) {
+            axisExitDist = (spaceMin[axis] + emptySpaceSize - start[axis]) * step[axis];
+        } else if (dir[axis] < 0) {
+            axisExitDist = (start[axis] - spaceMin[axis]) * step[axis];
+        } else {
+            continue;
+        }
+
+        if (axisExitDist < exitDist) {
+            exitDist = axisExitDist;
+            exitAxis = axis;
+        }
+    }
+
+    if (exitDist >= range) return false;
+
+    for (int32_t axis = 0; axis < 3; axis++) {
+        if (axis == exitAxis) {
+            blockPos[axis] = tileDir[axis] > 0 ? spaceMin[axis] + emptySpaceSize - 1 : spaceMin[axis];
+        } else if (dir[axis] != 0) {
+            int32_t exitPos = floorToInt(start[axis] + dir[axis] * exitDist);
+            blockPos[axis] = glm::clamp(exitPos, spaceMin[axis], spaceMin[axis] + emptySpaceSize - 1);
+        }
+    }
+
+    lastPos = blockPos;
+    blockPos[exitAxis] += tileDir[exitAxis];
+    lastDistToNext = exitDist;
+
+    // Distances to the next block boundaries, measured the same way as at the start of the ray.
+    for (int32_t axis = 0; axis < 3; axis++) {
+        if (dir[axis] > 0) {
+            distToNext[axis] = (blockPos[axis] + 1 - start[axis]) * step[axis];
+        } else if (dir[axis] < 0) {
+            distToNext[axis] = (start[axis] - blockPos[axis]) * step[axis];
+        }
+    }
+
+    return true;
+}
+
+// Step through the blocks along a ray until one isn't air. getBlock is called with the position of
+// each block the ray passes through. getEmptySpaceSize works like World::getEmptySpaceSize, the ray
+// jumps straight across empty chunks and bricks instead of stepping through each of their blocks.
+template <typename GetBlock, typename GetEmptySpaceSize>
+static RaycastHit traceRay(glm::vec3 start, glm::vec3 dir, float range, GetBlock&& getBlock,
+    GetEmptySpaceSize&& getEmptySpaceSize) {
     glm::ivec3 tileDir = glm::sign(dir);
     glm::vec3 step = glm::abs(1.0f / dir);
     glm::vec3 initialStep;
@@ -80,8 +235,27 @@ RaycastHit raycast(World& world, glm::vec3 start, glm::vec3 dir, float range) {
 
     float lastDistToNext = 0.0f;
 
-    Blocks hitBlock = world.getBlock(blockPos.x, blockPos.y, blockPos.z);
+    Blocks hitBlock = getBlock(blockPos);
+    // The last brick that was found to have blocks in it or to reach out of range, it doesn't need to be
+    // checked again. Rays stop as soon as they leave the world, so block positions are never negative here.
+    glm::ivec3 occupiedBrick(-1);
+
     while (hitBlock == Blocks::Air && lastDistToNext < range) {
+        glm::ivec3 brick(blockPos.x / brickSize, blockPos.y / brickSize, blockPos.z / brickSize);
+
+        if (brick.x != occupiedBrick.x || brick.y != occupiedBrick.y || brick.z != occupiedBrick.z) {
+            int32_t emptySpaceSize = getEmptySpaceSize(blockPos);
+
+            if (emptySpaceSize != 0 && skipEmptySpace(start, dir, range, step, tileDir, emptySpaceSize, blockPos,
+                lastPos, distToNext, lastDistToNext)) {
+
+                hitBlock = getBlock(blockPos);
+                continue;
+            }
+
+            occupiedBrick = brick;
+        }
+
         lastPos = blockPos;
 
         if (distToNext.x < distToNext.y && distToNext.x < distToNext.z) {
@@ -98,7 +272,7 @@ RaycastHit raycast(World& world, glm::vec3 start, glm::vec3 dir, float range) {
             blockPos.z += tileDir.z;
         }
 
-        hitBlock = world.getBlock(blockPos.x, blockPos.y, blockPos.z);
+        hitBlock = getBlock(blockPos);
     }
 
     return RaycastHit{
@@ -107,5 +281,125 @@ RaycastHit raycast(World& world, glm::vec3 start, glm::vec3 dir, float range) {
         lastDistToNext,
         blockPos,
         lastPos,
+        lastPos - blockPos,
+    };
+}
+
+RaycastHit raycast(World& world, glm::vec3 start, glm::vec3 dir, float range) {
+    auto getBlock = [&](glm::ivec3 pos) {
+        return world.getBlock(pos.x, pos.y, pos.z);
+    };
+
+    auto getEmptySpaceSize = [&](glm::ivec3 pos) {
+        return world.getEmptySpaceSize(pos.x, pos.y, pos.z);
     };
+
+    return traceRay(start, dir, range, getBlock, getEmptySpaceSize);
+}
+
+// Reads blocks straight out of the last chunk that was used, only going through the world when a
+// position is in a different chunk.
+struct BlockCache {
+    World& world;
+    int32_t chunkSize;
+    int32_t mapSize;
+    Chunk* chunk = nullptr;
+    const Blocks* chunkBlocks = nullptr;
+    // The world position of the cached chunk's first block.
+    glm::ivec3 chunkOrigin{0, 0, 0};
+
+    Blocks getBlock(glm::ivec3 pos) {
+        // Casting to unsigned turns the negative check into part of the upper bound check.
+        uint32_t localX = static_cast<uint32_t>(pos.x - chunkOrigin.x);
+        uint32_t localY = static_cast<uint32_t>(pos.y - chunkOrigin.y);
+        uint32_t localZ = static_cast<uint32_t>(pos.z - chunkOrigin.z);
+        uint32_t size = static_cast<uint32_t>(chunkSize);
+
+        if (localX < size && localY < size && localZ < size && chunkBlocks) {
+            return chunkBlocks[localX + localY * size + localZ * size * size];
+        }
+
+        return loadChunk(pos);
+    }
+
+    // Positions are always in the cached chunk, they were just passed to getBlock.
+    int32_t getEmptySpaceSize(glm::ivec3 pos) {
+        if (chunk->isEmpty()) return chunkSize;
+        if (chunk->isBrickEmpty(pos.x - chunkOrigin.x, pos.y - chunkOrigin.y, pos.z - chunkOrigin.z)) return brickSize;
+
+        return 0;
+    }
+
+    Blocks loadChunk(glm::ivec3 pos);
+};
+
+Blocks BlockCache::loadChunk(glm::ivec3 pos) {
+    // Matches World::getBlock, the outside of the world is solid.
+    if (pos.x < 0 || pos.x >= mapSize || pos.y < 0 || pos.y >= mapSize || pos.z < 0 || pos.z >= mapSize) {
+        return Blocks::Dirt;
+    }
+
+    glm::ivec3 chunkPos = pos / chunkSize;
+    chunkOrigin = chunkPos * chunkSize;
+    chunk = &world.getChunk(chunkPos.x, chunkPos.y, chunkPos.z);
+    chunkBlocks = chunk->getBlockData();
+    glm::ivec3 localPos = pos - chunkOrigin;
+
+    return chunkBlocks[localPos.x + localPos.y * chunkSize + localPos.z * chunkSize * chunkSize];
+}
+
+// Rays are traced in order of the chunk they start in, so consecutive rays mostly walk through the same
+// chunks. The chunk that was used last is kept around and blocks are read straight from its data, the
+// world is only asked for a chunk when a ray leaves the current one. Results match raycast exactly.
+void raycastBatch(World& world, const std::vector<Ray>& rays, std::vector<RaycastHit>& hits) {
+    PROFILE_ZONE("raycastBatch");
+
+    int32_t chunkSize = world.getChunkSize();
+    int32_t mapSizeInChunks = world.getMapSizeInChunks();
+    int32_t mapSize = world.getMapSize();
+    int32_t chunkCount = mapSizeInChunks * mapSizeInChunks * mapSizeInChunks;
+
+    hits.resize(rays.size());
+
+    // Counting sort the rays by their starting chunk, rays starting outside of the world go last.
+    std::vector<uint32_t> rayChunks(rays.size());
+    std::vector<uint32_t> chunkStarts(chunkCount + 2, 0);
+    std::vector<uint32_t> sortedRays(rays.size());
+
+    for (size_t i = 0; i < rays.size(); i++) {
+        glm::ivec3 blockPos = floorToInt(rays[i].start);
+        uint32_t chunkIndex = static_cast<uint32_t>(chunkCount);
+
+        if (blockPos.x >= 0 && blockPos.x < mapSize && blockPos.y >= 0 && blockPos.y < mapSize &&
+            blockPos.z >= 0 && blockPos.z < mapSize) {
+            glm::ivec3 chunkPos = blockPos / chunkSize;
+            chunkIndex = static_cast<uint32_t>(chunkPos.x + chunkPos.y * mapSizeInChunks + chunkPos.z * mapSizeInChunks * mapSizeInChunks);
+        }
+
+        rayChunks[i] = chunkIndex;
+        chunkStarts[chunkIndex + 1]++;
+    }
+
+    for (size_t i = 1; i < chunkStarts.size(); i++) {
+        chunkStarts[i] += chunkStarts[i - 1];
+    }
+
+    for (size_t i = 0; i < rays.size(); i++) {
+        sortedRays[chunkStarts[rayChunks[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    BlockCache blockCache{world, chunkSize, mapSize};
+
+    auto getBlock = [&](glm::ivec3 pos) {
+        return blockCache.getBlock(pos);
+    };
+
+    auto getEmptySpaceSize = [&](glm::ivec3 pos) {
+        return blockCache.getEmptySpaceSize(pos);
+    };
+
+    for (uint32_t rayIndex : sortedRays) {
+        const Ray& ray = rays[rayIndex];
+        hits[rayIndex] = traceRay(ray.start, ray.dir, ray.range, getBlock, getEmptySpaceSize);
+    }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <optional>
+#include <vector>
 
 #include "world.hpp"
 #include "gameMath.hpp"
@@ -13,10 +14,28 @@ struct RaycastHit {
     float distance;
     glm::ivec3 pos;
     glm::ivec3 lastPos;
+    // Points out of the face that was hit, zero if the ray started inside of the block.
+    glm::ivec3 normal;
+};
+
+struct Ray {
+    glm::vec3 start;
+    glm::vec3 dir;
+    float range;
+};
+
+struct SweepHit {
+    bool hit;
+    // How much of the motion can be travelled before touching a block, from 0 to 1.
+    float time;
+    glm::ivec3 normal;
+    glm::ivec3 pos;
 };
 
 bool isCollidingWithBlock(World& world, glm::vec3 pos, glm::vec3 size);
 std::optional<glm::ivec3> getBlockCollision(World& world, glm::vec3 pos, glm::vec3 size);
+SweepHit sweepBox(World& world, glm::vec3 pos, glm::vec3 size, glm::vec3 motion);
 bool overlapsBlock(float x, glm::vec3 pos, glm::vec3 size, glm::ivec3 blockPos);
 bool isOnGround(World& world, glm::vec3 pos, glm::vec3 size);
-RaycastHit raycast(World& world, glm::vec3 start, glm::vec3 dir, float range);
\ No newline at end of file
+RaycastHit raycast(World& world, glm::vec3 start, glm::vec3 dir, float range);
+void raycastBatch(World& world, const std::vector<Ray>& rays, std::vector<RaycastHit>& hits);
\ No newline at end of file
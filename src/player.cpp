@@ -1,5 +1,7 @@
 #include "player.hpp"
 
+#include "profiler.hpp"
+
 Player::Player() {
     updateRotation(0.0f, 0.0f);
 }
@@ -16,28 +18,38 @@ void Player::updateRotation(float dx, float dy) {
     rightDir = glm::vec3(rightVec.x, rightVec.y, rightVec.z);
 }
 
-glm::mat4 Player::getViewMatrix() {
+// Interpolation is how far the frame is between the last tick and the next one, from 0 to 1.
+glm::mat4 Player::getViewMatrix(float interpolation) {
+    glm::vec3 interpolatedViewPos = glm::mix(previousViewPos, viewPos, interpolation);
     glm::vec4 upVec = glm::rotate(glm::mat4(1.0f), glm::radians(viewTilt.x), forwardDir) * glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
     glm::vec4 forwardVec = glm::rotate(glm::mat4(1.0f), glm::radians(glm::clamp(viewTilt.y, -maxPitch - rotationX, maxPitch - rotationX)), rightDir) *
                            glm::vec4(forwardDir.x, forwardDir.y, forwardDir.z, 1.0f);
-    return glm::lookAt(viewPos, viewPos + glm::vec3(forwardVec.x, forwardVec.y, forwardVec.z), glm::vec3(upVec.x, upVec.y, upVec.z));
+    return glm::lookAt(interpolatedViewPos, interpolatedViewPos + glm::vec3(forwardVec.x, forwardVec.y, forwardVec.z), glm::vec3(upVec.x, upVec.y, upVec.z));
 }
 
 float Player::getFov() {
     return fov;
 }
 
-void Player::updateInteraction(Input& input, World& world, BlockInteraction& blockInteraction, float deltaTime) {
+// Blocks can't be edited until the area around them is done generating, see editableAreaRadius.
+static bool isEditable(World& world, WorldGenerator& worldGenerator, glm::ivec3 pos) {
+    int32_t chunkSize = world.getChunkSize();
+    return worldGenerator.isAreaGenerated(pos.x / chunkSize, pos.z / chunkSize, editableAreaRadius);
+}
+
+void Player::updateInteraction(Input& input, World& world, WorldGenerator& worldGenerator, BlockInteraction& blockInteraction, float deltaTime) {
+    PROFILE_ZONE("Player::updateInteraction");
+
     if (input.isButtonPressed(GLFW_MOUSE_BUTTON_LEFT)) {
         RaycastHit hit = raycast(world, viewPos, forwardDir, range);
 
-        if (hit.hit) {
+        if (hit.hit && isEditable(world, worldGenerator, hit.pos)) {
             blockInteraction.mineBlock(world, hit.pos.x, hit.pos.y, hit.pos.z, deltaTime);
         }
     } else if (input.wasButtonPressed(GLFW_MOUSE_BUTTON_RIGHT)) {
         RaycastHit hit = raycast(world, viewPos, forwardDir, range);
 
-        if (hit.hit) {
+        if (hit.hit && isEditable(world, worldGenerator, hit.lastPos)) {
             blockInteraction.placeBlock(world, hit.lastPos.x, hit.lastPos.y, hit.lastPos.z, Blocks::Stone);
         }
     }
@@ -61,26 +73,27 @@ bool Player::tryStepUp(World& world, glm::vec3 targetPos, glm::ivec3 hitBlock, b
     return false;
 }
 
-bool Player::canStep(World& world, glm::vec3 newPos, int32_t axis, bool isCrouching, bool isGrounded) {
-    glm::vec3 axisNewPos = pos;
-    axisNewPos[axis] = newPos[axis];
-    bool snagLedge = isCrouching && isGrounded && !isOnGround(world, axisNewPos, size);
-    if (snagLedge) {
-        return false;
-    } else {
-        auto collision = getBlockCollision(world, axisNewPos, size);
-        if (collision.has_value()) {
-            glm::ivec3 hitBlock = collision.value();
-            if (!tryStepUp(world, newPos, hitBlock, isGrounded)) {
-                return false;
-            }
-        }
+// Move along one axis up to the first block in the way, stepping up onto it if there's room.
+void Player::moveAxis(World& world, float distance, int32_t axis, bool isCrouching, bool isGrounded) {
+    glm::vec3 motion(0.0f);
+    motion[axis] = distance;
+
+    bool snagLedge = isCrouching && isGrounded && !isOnGround(world, pos + motion, size);
+    if (snagLedge) return;
+
+    SweepHit hit = sweepBox(world, pos, size, motion);
+
+    if (hit.hit && tryStepUp(world, pos + motion, hit.pos, isGrounded)) {
+        hit = sweepBox(world, pos, size, motion);
     }
 
-    return true;
+    setPos(pos + motion * hit.time);
 }
 
 void Player::updateMovement(Input& input, World& world, float deltaTime) {
+    PROFILE_ZONE("Player::updateMovement");
+
+    previousViewPos = viewPos;
     bool isGrounded = isOnGround(world, pos, size);
 
     glm::vec2 horizontalForwardDir = glm::vec2(forwardDir.x, forwardDir.z);
@@ -151,33 +164,24 @@ void Player::updateMovement(Input& input, World& world, float deltaTime) {
         }
     }
 
-    glm::vec3 newPos = pos;
-
     bool noClip = input.isButtonPressed(GLFW_KEY_N);
 
     if (!noClip) {
-        newPos.x += xVelocity;
+        moveAxis(world, xVelocity, 0, isCrouching, isGrounded);
+        moveAxis(world, zVelocity, 2, isCrouching, isGrounded);
 
-        if (!canStep(world, newPos, 0, isCrouching, isGrounded)) {
-            newPos.x = pos.x;
-        }
-
-        newPos.z += zVelocity;
-
-        if (!canStep(world, newPos, 2, isCrouching, isGrounded)) {
-            newPos.z = pos.z;
-        }
-
-        newPos.y = pos.y + yVelocity * deltaTime;
+        glm::vec3 fallMotion(0.0f, yVelocity * deltaTime, 0.0f);
+        SweepHit hit = sweepBox(world, pos, size, fallMotion);
 
-        if (isCollidingWithBlock(world, glm::vec3{pos.x, newPos.y, pos.z}, size)) {
+        if (hit.hit) {
             yVelocity = 0;
-            newPos.y = pos.y;
         }
+
+        setPos(pos + fallMotion * hit.time);
     }
 
     updateView(deltaTime);
-    setPos(newPos);
+    updateViewPos();
 }
 
 void Player::increaseViewInterp() {
@@ -202,4 +206,10 @@ void Player::updateViewPos() {
 void Player::setPos(glm::vec3 newPos) {
     pos = newPos;
     updateViewPos();
+}
+
+// Move without interpolating the view from the old position.
+void Player::teleport(glm::vec3 newPos) {
+    setPos(newPos);
+    previousViewPos = viewPos;
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "world.hpp"
+#include "worldGenerator.hpp"
 #include "physics.hpp"
 #include "blockInteraction.hpp"
 #include "input.hpp"
@@ -13,16 +14,17 @@ class Player {
 public:
     Player();
     void updateRotation(float dx, float dy);
-    glm::mat4 getViewMatrix();
+    glm::mat4 getViewMatrix(float interpolation);
     float getFov();
     bool tryStepUp(World& world, glm::vec3 targetPos, glm::ivec3 hitBlock, bool isGrounded);
-    bool canStep(World& world, glm::vec3 newPos, int32_t axis, bool isCrouching, bool isGrounded);
+    void moveAxis(World& world, float distance, int32_t axis, bool isCrouching, bool isGrounded);
     void updateMovement(Input& input, World& world, float deltaTime);
-    void updateInteraction(Input& input, World& world, BlockInteraction& blockInteraction, float deltaTime);
+    void updateInteraction(Input& input, World& world, WorldGenerator& worldGenerator, BlockInteraction& blockInteraction, float deltaTime);
     void increaseViewInterp();
     void updateView(float deltaTime);
     void updateViewPos();
     void setPos(glm::vec3 newPos);
+    void teleport(glm::vec3 newPos);
 
 private:
     float speed = 5.0f;
@@ -52,6 +54,8 @@ private:
     float range = 10.0f;
     glm::vec3 pos;
     glm::vec3 viewPos = pos;
+    // Where the view was at the start of the last tick, rendering blends from here to viewPos.
+    glm::vec3 previousViewPos = viewPos;
     glm::vec3 size{0.8f, 2.8f, 0.8f};
     glm::vec3 forwardDir;
     glm::vec3 rightDir;
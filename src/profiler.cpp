@@ -0,0 +1,131 @@
+#include "profiler.hpp"
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+struct ProfileEvent {
+    const char* name;
+    int64_t startTime;
+    int64_t endTime;
+};
+
+constexpr size_t profileBufferSize = 1 << 16;
+
+// Only the thread that owns the buffer writes events, the count is published after each event
+// is written so other threads can tell which events are complete.
+struct ProfileThreadBuffer {
+    int32_t threadId;
+    std::string threadName;
+    std::array<ProfileEvent, profileBufferSize> events;
+    std::atomic<uint64_t> eventCount = 0;
+};
+
+std::atomic<bool> isProfilerEnabled = true;
+
+// Buffers are kept after their thread exits, so that its zones still end up in the trace.
+static std::mutex threadBuffersMutex;
+static std::vector<std::unique_ptr<ProfileThreadBuffer>> threadBuffers;
+static thread_local ProfileThreadBuffer* threadBuffer = nullptr;
+
+static ProfileThreadBuffer& getThreadBuffer() {
+    if (!threadBuffer) {
+        std::lock_guard lock(threadBuffersMutex);
+
+        threadBuffers.push_back(std::make_unique<ProfileThreadBuffer>());
+        threadBuffer = threadBuffers.back().get();
+        threadBuffer->threadId = static_cast<int32_t>(threadBuffers.size());
+        threadBuffer->threadName = "Thread " + std::to_string(threadBuffer->threadId);
+    }
+
+    return *threadBuffer;
+}
+
+int64_t getProfilerTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void recordProfileZone(const char* name, int64_t startTime, int64_t endTime) {
+    ProfileThreadBuffer& buffer = getThreadBuffer();
+    uint64_t eventCount = buffer.eventCount.load(std::memory_order_relaxed);
+
+    buffer.events[eventCount % profileBufferSize] = ProfileEvent{name, startTime, endTime};
+    buffer.eventCount.store(eventCount + 1, std::memory_order_release);
+}
+
+void setProfilerEnabled(bool enabled) {
+    isProfilerEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void setProfilerThreadName(const std::string& name) {
+    ProfileThreadBuffer& buffer = getThreadBuffer();
+
+    std::lock_guard lock(threadBuffersMutex);
+    buffer.threadName = name;
+}
+
+// Quotes and backslashes are the only characters zone and thread names might need escaped.
+static std::string escapeJson(const std::string& string) {
+    std::string escaped;
+
+    for (char c : string) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+bool writeProfilerTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) return false;
+
+    std::lock_guard lock(threadBuffersMutex);
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"traceEvents\":[\n";
+    bool isFirstEvent = true;
+
+    for (const std::unique_ptr<ProfileThreadBuffer>& buffer : threadBuffers) {
+        if (!isFirstEvent) file << ",\n";
+        isFirstEvent = false;
+
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadId
+             << ",\"args\":{\"name\":\"" << escapeJson(buffer->threadName) << "\"}}";
+
+        // The owning thread keeps recording while the events are copied, so copy first and then
+        // drop any events that it may have overwritten in the meantime.
+        uint64_t endCount = buffer->eventCount.load(std::memory_order_acquire);
+        uint64_t startCount = endCount > profileBufferSize ? endCount - profileBufferSize : 0;
+        std::vector<ProfileEvent> events;
+        events.reserve(endCount - startCount);
+
+        for (uint64_t i = startCount; i < endCount; i++) {
+            events.push_back(buffer->events[i % profileBufferSize]);
+        }
+
+        // The owner may already be writing event newEndCount, which shares a slot with the event
+        // profileBufferSize before it, so that one is dropped too. The fence keeps the copies above
+        // from being read after the count.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t newEndCount = buffer->eventCount.load(std::memory_order_relaxed);
+        uint64_t overwrittenCount = newEndCount >= profileBufferSize ? newEndCount - profileBufferSize + 1 : 0;
+
+        for (uint64_t i = std::max(startCount, overwrittenCount); i < endCount; i++) {
+            const ProfileEvent& event = events[i - startCount];
+
+            // Chrome traces are in microseconds.
+            file << ",\n{\"name\":\"" << escapeJson(event.name) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadId
+                 << ",\"ts\":" << event.startTime / 1000.0 << ",\"dur\":" << (event.endTime - event.startTime) / 1000.0 << "}";
+        }
+    }
+
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
\ No newline at end of file
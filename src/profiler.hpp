@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cinttypes>
+#include <atomic>
+#include <string>
+
+// Scoped timing zones, PROFILE_ZONE("name") times the rest of the enclosing scope. Zones are only
+// compiled in when MPVOXELS_PROFILER is defined, and can be switched off at runtime with setProfilerEnabled.
+// Each thread records into its own ring buffer, so recording never takes a lock.
+
+#ifdef MPVOXELS_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
+
+extern std::atomic<bool> isProfilerEnabled;
+
+int64_t getProfilerTime();
+// The name has to outlive the profiler, string literals are expected.
+void recordProfileZone(const char* name, int64_t startTime, int64_t endTime);
+void setProfilerEnabled(bool enabled);
+// Name the calling thread in the trace.
+void setProfilerThreadName(const std::string& name);
+// Write every zone still in the ring buffers as Chrome trace JSON, viewable in chrome://tracing or Perfetto.
+bool writeProfilerTrace(const std::string& path);
+
+class ProfileZone {
+public:
+    ProfileZone(const char* name) : name(name) {
+        if (isProfilerEnabled.load(std::memory_order_relaxed)) {
+            startTime = getProfilerTime();
+        }
+    }
+
+    ~ProfileZone() {
+        if (startTime >= 0) {
+            recordProfileZone(name, startTime, getProfilerTime());
+        }
+    }
+
+private:
+    const char* name;
+    int64_t startTime = -1;
+};
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "protocol.hpp"
+
+#include <cstring>
+
+void PacketWriter::clear() {
+    data.clear();
+}
+
+void PacketWriter::writeU8(uint8_t value) {
+    data.push_back(value);
+}
+
+void PacketWriter::writeU16(uint16_t value) {
+    data.push_back(static_cast<uint8_t>(value));
+    data.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void PacketWriter::writeU32(uint32_t value) {
+    for (int32_t shift = 0; shift < 32; shift += 8) {
+        data.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void PacketWriter::writeI32(int32_t value) {
+    writeU32(static_cast<uint32_t>(value));
+}
+
+void PacketWriter::writeFloat(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU32(bits);
+}
+
+void PacketWriter::writeVec3(glm::vec3 value) {
+    writeFloat(value.x);
+    writeFloat(value.y);
+    writeFloat(value.z);
+}
+
+void PacketWriter::writeVarU32(uint32_t value) {
+    // The high bit of each byte is set when more bytes follow.
+    while (value >= 0x80) {
+        data.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    data.push_back(static_cast<uint8_t>(value));
+}
+
+void PacketWriter::writeBytes(const void* bytes, size_t size) {
+    const uint8_t* byteData = static_cast<const uint8_t*>(bytes);
+    data.insert(data.end(), byteData, byteData + size);
+}
+
+const std::vector<uint8_t>& PacketWriter::getData() const {
+    return data;
+}
+
+PacketReader::PacketReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+bool PacketReader::readU8(uint8_t& value) {
+    if (getRemainingSize() < 1) return false;
+
+    value = data[offset];
+    offset++;
+
+    return true;
+}
+
+bool PacketReader::readU16(uint16_t& value) {
+    if (getRemainingSize() < 2) return false;
+
+    value = static_cast<uint16_t>(data[offset] | data[offset + 1] << 8);
+    offset += 2;
+
+    return true;
+}
+
+bool PacketReader::readU32(uint32_t& value) {
+    if (getRemainingSize() < 4) return false;
+
+    value = 0;
+
+    for (int32_t i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(data[offset + i]) << (i * 8);
+    }
+
+    offset += 4;
+
+    return true;
+}
+
+bool PacketReader::readI32(int32_t& value) {
+    uint32_t bits;
+    if (!readU32(bits)) return false;
+
+    value = static_cast<int32_t>(bits);
+
+    return true;
+}
+
+bool PacketReader::readFloat(float& value) {
+    uint32_t bits;
+    if (!readU32(bits)) return false;
+
+    std::memcpy(&value, &bits, sizeof(value));
+
+    return true;
+}
+
+bool PacketReader::readVec3(glm::vec3& value) {
+    return readFloat(value.x) && readFloat(value.y) && readFloat(value.z);
+}
+
+bool PacketReader::readVarU32(uint32_t& value) {
+    value = 0;
+
+    for (int32_t shift = 0; shift < 32; shift += 7) {
+        uint8_t byte;
+        if (!readU8(byte)) return false;
+
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+
+    // Too many bytes for a 32 bit value.
+    return false;
+}
+
+bool PacketReader::readBytes(void* bytes, size_t size) {
+    if (getRemainingSize() < size) return false;
+
+    std::memcpy(bytes, data + offset, size);
+    offset += size;
+
+    return true;
+}
+
+size_t PacketReader::getRemainingSize() {
+    return size - offset;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Messages sent between the server and its clients. Every packet starts with its MessageType, followed by
+// the message's fields in little endian order.
+
+// Clients send this as their connect data, the server turns away clients with a different version.
+constexpr uint32_t protocolVersion = 4;
+constexpr uint16_t defaultServerPort = 7777;
+
+enum class Channel : uint8_t {
+    // Chunks and block edits, these arrive in order and are never dropped.
+    Reliable,
+    // Movement and entity positions, only the latest ones matter so lost packets aren't resent.
+    Movement,
+    Count,
+};
+
+enum class MessageType : uint8_t {
+    // Server to client.
+    // Sent once on connect: the protocol version, the client's entity id, chunk size, map size in chunks and tick rate.
+    Welcome,
+    // Chunk coordinates and the chunk's version, followed by its blocks encoded by ChunkCodec.
+    ChunkData,
+    // Every edit made to a chunk in one tick, written by EditLog.
+    BlockEdits,
+    // The tick, entity count and then an id and position for each entity.
+    EntityPositions,
+    // Chunk coordinates of a chunk that's out of the client's view, it won't be sent edits until it comes back.
+    UnloadChunk,
+
+    // Client to server.
+    // The tick, the horizontal direction the player wants to move in and whether they want to jump.
+    Movement,
+    // A block the player wants to change, as world coordinates and the new block.
+    EditBlock,
+};
+
+class PacketWriter {
+public:
+    void clear();
+    void writeU8(uint8_t value);
+    void writeU16(uint16_t value);
+    void writeU32(uint32_t value);
+    void writeI32(int32_t value);
+    void writeFloat(float value);
+    void writeVec3(glm::vec3 value);
+    // Seven bits per byte, so small values take less space.
+    void writeVarU32(uint32_t value);
+    void writeBytes(const void* bytes, size_t size);
+    const std::vector<uint8_t>& getData() const;
+
+private:
+    std::vector<uint8_t> data;
+};
+
+// Reads fields from a received packet. Reads return false once the packet runs out of data,
+// since packets come from outside of the game and can't be trusted to be well formed.
+class PacketReader {
+public:
+    PacketReader(const uint8_t* data, size_t size);
+    bool readU8(uint8_t& value);
+    bool readU16(uint16_t& value);
+    bool readU32(uint32_t& value);
+    bool readI32(int32_t& value);
+    bool readFloat(float& value);
+    bool readVec3(glm::vec3& value);
+    bool readVarU32(uint32_t& value);
+    bool readBytes(void* bytes, size_t size);
+    size_t getRemainingSize();
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+};
\ No newline at end of file
@@ -6,11 +6,12 @@
 #include <vulkan/vulkan.hpp>
 #include <glm/glm.hpp>
 
-struct VertexData {
-    glm::vec3 pos;
-    glm::vec3 color;
-    glm::vec3 texCoord;
+#include "meshTypes.hpp"
 
+// Layouts of the vertex formats in meshTypes.hpp, used when creating pipelines.
+// They add nothing to the formats, so they have the same size.
+
+struct VertexDataLayout : VertexData {
     static VkVertexInputBindingDescription getBindingDescription() {
         VkVertexInputBindingDescription bindingDescription{};
         bindingDescription.binding = 0;
@@ -42,10 +43,7 @@ struct VertexData {
     }
 };
 
-struct TransparentVertexData {
-    alignas(16) glm::vec3 pos;
-    alignas(16) glm::vec4 color;
-
+struct TransparentVertexDataLayout : TransparentVertexData {
     static VkVertexInputBindingDescription getBindingDescription() {
         VkVertexInputBindingDescription bindingDescription{};
         bindingDescription.binding = 0;
@@ -72,10 +70,7 @@ struct TransparentVertexData {
     }
 };
 
-struct InstanceData {
-  public:
-    glm::vec3 pos;
-
+struct InstanceDataLayout : InstanceData {
     static VkVertexInputBindingDescription getBindingDescription() {
         VkVertexInputBindingDescription bindingDescription{};
         bindingDescription.binding = 1;
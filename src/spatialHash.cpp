@@ -0,0 +1,107 @@
+#include "spatialHash.hpp"
+
+#include <algorithm>
+
+#include "gameMath.hpp"
+
+// The bucket count is rounded up to a power of two so cells can be mapped to buckets with a mask.
+SpatialHash::SpatialHash(float cellSize, size_t bucketCount) : cellSize(cellSize) {
+    size_t powerOfTwoCount = 1;
+
+    while (powerOfTwoCount < bucketCount) {
+        powerOfTwoCount *= 2;
+    }
+
+    bucketMask = static_cast<uint32_t>(powerOfTwoCount - 1);
+    bucketStarts.resize(powerOfTwoCount + 1);
+    bucketEnds.resize(powerOfTwoCount);
+}
+
+void SpatialHash::build(EntityStore& entities) {
+    std::vector<glm::vec3>& positions = entities.getPositions();
+    size_t count = entities.getCount();
+
+    entityBuckets.resize(count);
+    entityCells.resize(count);
+    sortedIndices.resize(count);
+    std::fill(bucketStarts.begin(), bucketStarts.end(), 0);
+
+    for (size_t i = 0; i < count; i++) {
+        glm::ivec3 cell = getCell(positions[i]);
+        uint32_t bucket = getBucket(cell);
+        entityCells[i] = cell;
+        entityBuckets[i] = bucket;
+        bucketStarts[bucket + 1]++;
+    }
+
+    for (size_t i = 1; i < bucketStarts.size(); i++) {
+        bucketStarts[i] += bucketStarts[i - 1];
+    }
+
+    std::copy(bucketStarts.begin(), bucketStarts.end() - 1, bucketEnds.begin());
+
+    for (size_t i = 0; i < count; i++) {
+        sortedIndices[bucketEnds[entityBuckets[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+void SpatialHash::query(EntityStore& entities, glm::vec3 min, glm::vec3 max, std::vector<uint32_t>& results) {
+    std::vector<glm::vec3>& positions = entities.getPositions();
+    std::vector<glm::vec3>& sizes = entities.getSizes();
+
+    // Entities can stick out of their cell by up to half a cell.
+    glm::ivec3 minCell = getCell(min - cellSize * 0.5f);
+    glm::ivec3 maxCell = getCell(max + cellSize * 0.5f);
+
+    for (int32_t z = minCell.z; z <= maxCell.z; z++) {
+        for (int32_t y = minCell.y; y <= maxCell.y; y++) {
+            for (int32_t x = minCell.x; x <= maxCell.x; x++) {
+                glm::ivec3 cell(x, y, z);
+                uint32_t bucket = getBucket(cell);
+
+                for (uint32_t i = bucketStarts[bucket]; i < bucketStarts[bucket + 1]; i++) {
+                    uint32_t index = sortedIndices[i];
+                    // Skip entities from other cells in the same bucket, they're found when their own cell is visited.
+                    if (entityCells[index] != cell) continue;
+
+                    glm::vec3 halfSize = sizes[index] * 0.5f;
+                    glm::vec3 entityMin = positions[index] - halfSize;
+                    glm::vec3 entityMax = positions[index] + halfSize;
+
+                    if (entityMin.x < max.x && entityMax.x > min.x &&
+                        entityMin.y < max.y && entityMax.y > min.y &&
+                        entityMin.z < max.z && entityMax.z > min.z) {
+                        results.push_back(index);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SpatialHash::findPairs(EntityStore& entities, std::vector<std::pair<uint32_t, uint32_t>>& pairs) {
+    std::vector<glm::vec3>& positions = entities.getPositions();
+    std::vector<glm::vec3>& sizes = entities.getSizes();
+    size_t count = entities.getCount();
+
+    for (size_t i = 0; i < count; i++) {
+        glm::vec3 halfSize = sizes[i] * 0.5f;
+
+        queryResults.clear();
+        query(entities, positions[i] - halfSize, positions[i] + halfSize, queryResults);
+
+        for (uint32_t other : queryResults) {
+            if (other <= i) continue;
+
+            pairs.push_back(std::make_pair(static_cast<uint32_t>(i), other));
+        }
+    }
+}
+
+glm::ivec3 SpatialHash::getCell(glm::vec3 pos) {
+    return floorToInt(pos / cellSize);
+}
+
+uint32_t SpatialHash::getBucket(glm::ivec3 cell) {
+    return static_cast<uint32_t>(hashVector(cell.x, cell.y, cell.z)) & bucketMask;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "entities.hpp"
+
+// Uniform grid broadphase for entity-entity queries. Entities are bucketed by the cell that their center
+// is in, cells hash into a fixed number of buckets and each entity remembers its cell so cells that share
+// a bucket can be told apart. Rebuilding is a counting sort, so it doesn't allocate
+// once the buffers have grown. Cells need to be at least as big as the largest entity, then entities
+// that overlap are always in neighboring cells.
+class SpatialHash {
+public:
+    SpatialHash(float cellSize, size_t bucketCount);
+    void build(EntityStore& entities);
+    // Append the indices of every entity whose box overlaps the box from min to max.
+    void query(EntityStore& entities, glm::vec3 min, glm::vec3 max, std::vector<uint32_t>& results);
+    // Find every pair of overlapping entities, the lower index is first in each pair.
+    void findPairs(EntityStore& entities, std::vector<std::pair<uint32_t, uint32_t>>& pairs);
+
+private:
+    glm::ivec3 getCell(glm::vec3 pos);
+    uint32_t getBucket(glm::ivec3 cell);
+
+    float cellSize;
+    uint32_t bucketMask;
+
+    // The entities in bucket i are sortedIndices[bucketStarts[i]] to sortedIndices[bucketStarts[i + 1] - 1].
+    std::vector<uint32_t> bucketStarts;
+    std::vector<uint32_t> bucketEnds;
+    std::vector<uint32_t> sortedIndices;
+    std::vector<uint32_t> entityBuckets;
+    std::vector<glm::ivec3> entityCells;
+    std::vector<uint32_t> queryResults;
+};
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "stats.hpp"
+
+#include <array>
+#include <atomic>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+
+const std::array<const char*, static_cast<size_t>(Counter::Count)> counterNames = {
+    "chunks generated",
+    "chunks meshed",
+    "vertices",
+    "indices",
+    "bytes uploaded",
+    "draw calls",
+    "chunks culled",
+    "packets sent",
+    "bytes sent",
+    "chunks encoded",
+};
+
+const std::array<const char*, static_cast<size_t>(Gauge::Count)> gaugeNames = {
+    "mesh queue depth",
+};
+
+const std::array<const char*, static_cast<size_t>(Histogram::Count)> histogramNames = {
+    "chunk mesh time",
+    "frame time",
+    "tick time",
+};
+
+// Histogram buckets grow by a factor of sqrt(2), starting at histogramBaseTime milliseconds.
+// The last bucket holds everything above the others.
+constexpr size_t histogramBucketCount = 32;
+constexpr float histogramBaseTime = 1.0f / 64.0f;
+
+struct HistogramData {
+    std::array<std::atomic<int64_t>, histogramBucketCount> buckets{};
+    // Sum of the recorded times in microseconds, for the mean.
+    std::atomic<int64_t> totalTime = 0;
+};
+
+static std::array<std::atomic<int64_t>, static_cast<size_t>(Counter::Count)> counters{};
+static std::array<std::atomic<int64_t>, static_cast<size_t>(Gauge::Count)> gauges{};
+static std::array<HistogramData, static_cast<size_t>(Histogram::Count)> histograms;
+
+void addCounter(Counter counter, int64_t amount) {
+    counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void setGauge(Gauge gauge, int64_t value) {
+    gauges[static_cast<size_t>(gauge)].store(value, std::memory_order_relaxed);
+}
+
+static float getBucketUpperBound(size_t bucket) {
+    return histogramBaseTime * std::exp2(static_cast<float>(bucket) * 0.5f);
+}
+
+void recordHistogram(Histogram histogram, float milliseconds) {
+    size_t bucket = 0;
+
+    while (bucket < histogramBucketCount - 1 && milliseconds > getBucketUpperBound(bucket)) {
+        bucket++;
+    }
+
+    HistogramData& data = histograms[static_cast<size_t>(histogram)];
+    data.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    data.totalTime.fetch_add(static_cast<int64_t>(milliseconds * 1000.0f), std::memory_order_relaxed);
+}
+
+StatsReporter::StatsReporter(float interval, const std::string& path) : interval(interval), useFile(!path.empty()) {
+    if (useFile) {
+        file.open(path);
+    }
+}
+
+void StatsReporter::update(float currentTime) {
+    if (lastReportTime < 0.0f) {
+        lastReportTime = currentTime;
+        return;
+    }
+
+    float elapsedTime = currentTime - lastReportTime;
+    if (elapsedTime < interval) return;
+
+    report(elapsedTime);
+    lastReportTime = currentTime;
+}
+
+// Counters and histograms are reset after each report, so every report covers one interval.
+void StatsReporter::report(float elapsedTime) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    out << "stats over " << elapsedTime << "s:\n";
+
+    for (size_t i = 0; i < counters.size(); i++) {
+        int64_t count = counters[i].exchange(0, std::memory_order_relaxed);
+        out << "  " << counterNames[i] << ": " << count / elapsedTime << "/s\n";
+    }
+
+    for (size_t i = 0; i < gauges.size(); i++) {
+        out << "  " << gaugeNames[i] << ": " << gauges[i].load(std::memory_order_relaxed) << "\n";
+    }
+
+    out << std::setprecision(3);
+
+    for (size_t i = 0; i < histograms.size(); i++) {
+        HistogramData& data = histograms[i];
+        std::array<int64_t, histogramBucketCount> buckets;
+        int64_t sampleCount = 0;
+
+        for (size_t bucket = 0; bucket < histogramBucketCount; bucket++) {
+            buckets[bucket] = data.buckets[bucket].exchange(0, std::memory_order_relaxed);
+            sampleCount += buckets[bucket];
+        }
+
+        int64_t totalTime = data.totalTime.exchange(0, std::memory_order_relaxed);
+
+        out << "  " << histogramNames[i] << ": " << sampleCount << " samples";
+
+        if (sampleCount > 0) {
+            out << ", mean " << totalTime / 1000.0f / sampleCount << "ms";
+
+            // Percentiles are the upper bound of the bucket they fall in.
+            const std::array<float, 3> percentiles = {0.5f, 0.9f, 0.99f};
+            int64_t seenCount = 0;
+            size_t percentile = 0;
+
+            for (size_t bucket = 0; bucket < histogramBucketCount && percentile < percentiles.size(); bucket++) {
+                seenCount += buckets[bucket];
+
+                while (percentile < percentiles.size() && seenCount >= percentiles[percentile] * sampleCount) {
+                    out << ", p" << static_cast<int32_t>(percentiles[percentile] * 100.0f) << " <= ";
+
+                    if (bucket == histogramBucketCount - 1) {
+                        out << "inf";
+                    } else {
+                        out << getBucketUpperBound(bucket) << "ms";
+                    }
+
+                    percentile++;
+                }
+            }
+        }
+
+        out << "\n";
+    }
+
+    if (useFile) {
+        file << out.str();
+        file.flush();
+    } else {
+        std::cout << out.str();
+    }
+}
\ No newline at end of file
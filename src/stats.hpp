@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cinttypes>
+#include <string>
+#include <fstream>
+
+// Counters of engine work, reported as rates by StatsReporter. They can be updated from any thread.
+enum class Counter {
+    ChunksGenerated,
+    ChunksMeshed,
+    VerticesEmitted,
+    IndicesEmitted,
+    BytesUploaded,
+    DrawCalls,
+    ChunksCulled,
+    PacketsSent,
+    BytesSent,
+    ChunksEncoded,
+    Count,
+};
+
+// Values that are reported as they are, rather than as rates.
+enum class Gauge {
+    MeshQueueDepth,
+    Count,
+};
+
+enum class Histogram {
+    ChunkMeshTime,
+    FrameTime,
+    TickTime,
+    Count,
+};
+
+void addCounter(Counter counter, int64_t amount = 1);
+void setGauge(Gauge gauge, int64_t value);
+void recordHistogram(Histogram histogram, float milliseconds);
+
+// Writes the stats to a file, or stdout if the path is empty, once every interval.
+class StatsReporter {
+public:
+    StatsReporter(float interval, const std::string& path);
+    void update(float currentTime);
+
+private:
+    void report(float elapsedTime);
+
+    float interval;
+    float lastReportTime = -1.0f;
+    std::ofstream file;
+    bool useFile;
+};
\ No newline at end of file
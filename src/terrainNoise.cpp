@@ -0,0 +1,145 @@
+#include "terrainNoise.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "gameMath.hpp"
+#include "profiler.hpp"
+
+const float hillNoiseScale = 0.05f;
+const float hillHeight = 64.0f;
+const float valleyHeight = 32.0f;
+// Keeps rounding in the interpolation from pushing a value over a threshold it was checked against.
+const float latticeThresholdMargin = 0.0001f;
+
+int32_t ColumnHeightmap::getHeight(int32_t x, int32_t z, int32_t chunkSize) {
+    return heights[x + z * chunkSize];
+}
+
+ColumnHeightmap generateHeightmap(BatchNoise& noise, int32_t chunkSize, int32_t worldX, int32_t worldZ) {
+    PROFILE_ZONE("generateHeightmap");
+
+    ColumnHeightmap heightmap;
+    heightmap.heights.resize(chunkSize * chunkSize);
+
+    // Height noise is evaluated a whole row at a time so that it can be batched.
+    std::vector<float> xs(chunkSize);
+    std::vector<float> zs(chunkSize);
+    std::vector<float> heightNoise(chunkSize);
+
+    for (int32_t z = 0; z < chunkSize; z++) {
+        for (int32_t x = 0; x < chunkSize; x++) {
+            xs[x] = (worldX + x) * hillNoiseScale;
+            zs[x] = (worldZ + z) * hillNoiseScale;
+        }
+
+        noise.noise2D_01(xs.data(), zs.data(), heightNoise.data(), chunkSize);
+
+        for (int32_t x = 0; x < chunkSize; x++) {
+            heightmap.heights[x + z * chunkSize] = floorToInt(heightNoise[x] * hillHeight + valleyHeight);
+        }
+    }
+
+    auto [minHeight, maxHeight] = std::minmax_element(heightmap.heights.begin(), heightmap.heights.end());
+    heightmap.minHeight = *minHeight;
+    heightmap.maxHeight = *maxHeight;
+
+    return heightmap;
+}
+
+TerrainNoiseField::TerrainNoiseField(BatchNoise& noise, float scale, TerrainSettings settings, int32_t chunkSize, glm::ivec3 worldPos)
+    : noise(noise), scale(scale), settings(settings), chunkSize(chunkSize), worldPos(worldPos) {
+
+    if (settings.interpolateNoise) {
+        // Chunks only share the samples on their borders if the lattice lines up with them, otherwise there are seams.
+        assert(settings.noiseSpacing > 0 && chunkSize % settings.noiseSpacing == 0);
+
+        latticeSize = (chunkSize + settings.noiseSpacing - 1) / settings.noiseSpacing + 1;
+        sampleLattice();
+    }
+}
+
+void TerrainNoiseField::sampleColumn(int32_t x, int32_t z, int32_t height, float* results) {
+    if (!settings.interpolateNoise) {
+        xs.resize(height);
+        ys.resize(height);
+        zs.resize(height);
+
+        for (int32_t y = 0; y < height; y++) {
+            xs[y] = (worldPos.x + x) * scale;
+            ys[y] = (worldPos.y + y) * scale;
+            zs[y] = (worldPos.z + z) * scale;
+        }
+
+        noise.noise3D_01(xs.data(), ys.data(), zs.data(), results, height);
+        return;
+    }
+
+    int32_t spacing = settings.noiseSpacing;
+    int32_t cellX = x / spacing;
+    int32_t cellZ = z / spacing;
+    float tx = static_cast<float>(x - cellX * spacing) / spacing;
+    float tz = static_cast<float>(z - cellZ * spacing) / spacing;
+
+    // Interpolate horizontally once per lattice layer, then each block only has to interpolate vertically.
+    float lowerLayer = 0.0f;
+    float upperLayer = 0.0f;
+    int32_t layerY = -1;
+
+    for (int32_t y = 0; y < height; y++) {
+        int32_t cellY = y / spacing;
+
+        if (cellY != layerY) {
+            layerY = cellY;
+
+            for (int32_t i = 0; i < 2; i++) {
+                float v00 = lattice[getLatticeIndex(cellX, cellY + i, cellZ)];
+                float v10 = lattice[getLatticeIndex(cellX + 1, cellY + i, cellZ)];
+                float v01 = lattice[getLatticeIndex(cellX, cellY + i, cellZ + 1)];
+                float v11 = lattice[getLatticeIndex(cellX + 1, cellY + i, cellZ + 1)];
+                float layer = glm::mix(glm::mix(v00, v10, tx), glm::mix(v01, v11, tx), tz);
+
+                if (i == 0) {
+                    lowerLayer = layer;
+                } else {
+                    upperLayer = layer;
+                }
+            }
+        }
+
+        float ty = static_cast<float>(y - cellY * spacing) / spacing;
+        results[y] = glm::mix(lowerLayer, upperLayer, ty);
+    }
+}
+
+bool TerrainNoiseField::isAlwaysBelow(float threshold) {
+    if (!settings.interpolateNoise) return false;
+
+    // Interpolated values never leave the range of the lattice samples around them.
+    return *std::max_element(lattice.begin(), lattice.end()) < threshold - latticeThresholdMargin;
+}
+
+void TerrainNoiseField::sampleLattice() {
+    int32_t latticeCount = latticeSize * latticeSize * latticeSize;
+    lattice.resize(latticeCount);
+    xs.resize(latticeCount);
+    ys.resize(latticeCount);
+    zs.resize(latticeCount);
+
+    for (int32_t z = 0; z < latticeSize; z++) {
+        for (int32_t y = 0; y < latticeSize; y++) {
+            for (int32_t x = 0; x < latticeSize; x++) {
+                int32_t i = getLatticeIndex(x, y, z);
+                xs[i] = (worldPos.x + x * settings.noiseSpacing) * scale;
+                ys[i] = (worldPos.y + y * settings.noiseSpacing) * scale;
+                zs[i] = (worldPos.z + z * settings.noiseSpacing) * scale;
+            }
+        }
+    }
+
+    noise.noise3D_01(xs.data(), ys.data(), zs.data(), lattice.data(), latticeCount);
+}
+
+int32_t TerrainNoiseField::getLatticeIndex(int32_t x, int32_t y, int32_t z) {
+    return x + y * latticeSize + z * latticeSize * latticeSize;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "batchNoise.hpp"
+
+struct TerrainSettings {
+    // Sample 3D noise on a coarse lattice and interpolate between the samples,
+    // instead of sampling the noise for every block.
+    bool interpolateNoise = true;
+    // Distance in blocks between lattice samples, this must divide the chunk size
+    // so that neighboring chunks share the samples on their borders.
+    int32_t noiseSpacing = 4;
+};
+
+// Surface heights for a column of chunks, generated once and shared by every chunk stacked in the column.
+struct ColumnHeightmap {
+    std::vector<int32_t> heights;
+    int32_t minHeight;
+    int32_t maxHeight;
+
+    int32_t getHeight(int32_t x, int32_t z, int32_t chunkSize);
+};
+
+ColumnHeightmap generateHeightmap(BatchNoise& noise, int32_t chunkSize, int32_t worldX, int32_t worldZ);
+
+// One 3D noise field covering a chunk.
+class TerrainNoiseField {
+public:
+    TerrainNoiseField(BatchNoise& noise, float scale, TerrainSettings settings, int32_t chunkSize, glm::ivec3 worldPos);
+    // Fills results with the noise for the bottom height blocks of a column.
+    void sampleColumn(int32_t x, int32_t z, int32_t height, float* results);
+    // Check if the noise is under the threshold everywhere in the chunk, only known for interpolated noise.
+    bool isAlwaysBelow(float threshold);
+
+private:
+    void sampleLattice();
+    int32_t getLatticeIndex(int32_t x, int32_t y, int32_t z);
+
+    BatchNoise& noise;
+    float scale;
+    TerrainSettings settings;
+    int32_t chunkSize;
+    glm::ivec3 worldPos;
+    int32_t latticeSize = 0;
+
+    std::vector<float> lattice;
+    std::vector<float> xs, ys, zs;
+};
\ No newline at end of file
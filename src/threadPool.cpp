@@ -0,0 +1,99 @@
+#include "threadPool.hpp"
+
+#include <algorithm>
+
+#include "profiler.hpp"
+
+ThreadPool::ThreadPool() : ThreadPool(std::max(std::thread::hardware_concurrency(), 1u)) {}
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    threads.reserve(threadCount);
+
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.push_back(std::thread([this]() {
+            work();
+        }));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+
+    taskAvailable.notify_all();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(task));
+        unfinishedTasks++;
+    }
+
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    tasksFinished.wait(lock, [this]() {
+        return unfinishedTasks == 0;
+    });
+}
+
+// Only waits for its own tasks, so it can be used while other work is running in the pool.
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+    size_t remainingTasks = count;
+
+    for (size_t i = 0; i < count; i++) {
+        enqueue([this, &task, &remainingTasks, i]() {
+            task(i);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            remainingTasks--;
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    tasksFinished.wait(lock, [&remainingTasks]() {
+        return remainingTasks == 0;
+    });
+}
+
+size_t ThreadPool::getThreadCount() {
+    return threads.size();
+}
+
+void ThreadPool::work() {
+    setProfilerThreadName("Thread pool worker");
+
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() {
+                return isStopping || !tasks.empty();
+            });
+
+            if (isStopping && tasks.empty()) return;
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            unfinishedTasks--;
+        }
+
+        tasksFinished.notify_all();
+    }
+}
\ No newline at end of file
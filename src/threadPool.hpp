@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class ThreadPool {
+public:
+    ThreadPool();
+    ThreadPool(size_t threadCount);
+    ~ThreadPool();
+    void enqueue(std::function<void()> task);
+    void wait();
+    // Run task for every index in [0, count) across the pool and wait for them all to finish.
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+    size_t getThreadCount();
+
+private:
+    void work();
+
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable tasksFinished;
+    size_t unfinishedTasks = 0;
+    bool isStopping = false;
+};
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "world.hpp"
 
+#include <algorithm>
+
 #include "chunk.hpp"
+#include "stats.hpp"
 
 World::World(int32_t chunkSize, int32_t mapSizeInChunks) : chunkSize(chunkSize), mapSizeInChunks(mapSizeInChunks) {
     mapSize = chunkSize * mapSizeInChunks;
@@ -12,12 +15,12 @@ World::World(int32_t chunkSize, int32_t mapSizeInChunks) : chunkSize(chunkSize),
         int32_t x = i % mapSizeInChunks;
         int32_t y = (i / mapSizeInChunks) % mapSizeInChunks;
         int32_t z = i / (mapSizeInChunks * mapSizeInChunks);
-        chunks.push_back(Chunk(chunkSize, x, y, z));
+        chunks.push_back(std::make_unique<Chunk>(chunkSize, x, y, z));
     }
 }
 
 Chunk& World::getChunk(int32_t x, int32_t y, int32_t z) {
-    return chunks[x + y * mapSizeInChunks + z * mapSizeInChunks * mapSizeInChunks];
+    return *chunks[x + y * mapSizeInChunks + z * mapSizeInChunks * mapSizeInChunks];
 }
 
 void World::updateChunk(int32_t x, int32_t y, int32_t z) {
@@ -26,7 +29,22 @@ void World::updateChunk(int32_t x, int32_t y, int32_t z) {
     getChunk(x, y, z).needsUpdate = true;
 }
 
+// Relighting writes into the chunks around the edit, so meshing has to wait until it's done.
 void World::setBlock(int32_t x, int32_t y, int32_t z, Blocks block) {
+    std::lock_guard lock(meshMutex);
+    setBlockLocked(x, y, z, block);
+}
+
+void World::setBlocks(const std::vector<BlockEdit>& edits) {
+    std::lock_guard lock(meshMutex);
+
+    for (const BlockEdit& edit : edits) {
+        setBlockLocked(edit.x, edit.y, edit.z, edit.block);
+    }
+}
+
+// The mesh mutex must be held.
+void World::setBlockLocked(int32_t x, int32_t y, int32_t z, Blocks block) {
     if (x < 0 || x >= mapSize || y < 0 || y >= mapSize || z < 0 || z >= mapSize) return;
 
     int32_t chunkX = x / chunkSize;
@@ -36,8 +54,14 @@ void World::setBlock(int32_t x, int32_t y, int32_t z, Blocks block) {
     int32_t localY = y % chunkSize;
     int32_t localZ = z % chunkSize;
     Chunk& chunk = getChunk(chunkX, chunkY, chunkZ);
-    if (!chunk.setBlock(*this, localX, localY, localZ, block)) return;
+    if (!chunk.setBlock(localX, localY, localZ, block)) return;
+
+    updateNeighborChunks(chunkX, chunkY, chunkZ, localX, localY, localZ);
+    lightEngine.updateBlock(*this, x, y, z, block);
+}
 
+// Blocks on the edge of a chunk are part of the neighboring chunk's mesh too.
+void World::updateNeighborChunks(int32_t chunkX, int32_t chunkY, int32_t chunkZ, int32_t localX, int32_t localY, int32_t localZ) {
     int32_t maxPos = chunkSize - 1;
 
     if (localX == 0)      updateChunk(chunkX - 1, chunkY, chunkZ);
@@ -61,8 +85,8 @@ Blocks World::getBlock(int32_t x, int32_t y, int32_t z) {
     return chunk.getBlock(localX, localY, localZ);
 }
 
-bool World::getLit(int32_t x, int32_t y, int32_t z) {
-    if (x < 0 || x >= mapSize || y < 0 || y >= mapSize || z < 0 || z >= mapSize) return false;
+void World::setLight(int32_t x, int32_t y, int32_t z, LightChannel channel, uint8_t level) {
+    if (x < 0 || x >= mapSize || y < 0 || y >= mapSize || z < 0 || z >= mapSize) return;
 
     int32_t chunkX = x / chunkSize;
     int32_t chunkY = y / chunkSize;
@@ -71,7 +95,26 @@ bool World::getLit(int32_t x, int32_t y, int32_t z) {
     int32_t localY = y % chunkSize;
     int32_t localZ = z % chunkSize;
     Chunk& chunk = getChunk(chunkX, chunkY, chunkZ);
-    return chunk.getLit(localX, localY, localZ);
+    chunk.setLight(localX, localY, localZ, channel, level);
+
+    updateNeighborChunks(chunkX, chunkY, chunkZ, localX, localY, localZ);
+}
+
+uint8_t World::getLight(int32_t x, int32_t y, int32_t z, LightChannel channel) {
+    if (x < 0 || x >= mapSize || y < 0 || y >= mapSize || z < 0 || z >= mapSize) return 0;
+
+    int32_t chunkX = x / chunkSize;
+    int32_t chunkY = y / chunkSize;
+    int32_t chunkZ = z / chunkSize;
+    int32_t localX = x % chunkSize;
+    int32_t localY = y % chunkSize;
+    int32_t localZ = z % chunkSize;
+    Chunk& chunk = getChunk(chunkX, chunkY, chunkZ);
+    return chunk.getLight(localX, localY, localZ, channel);
+}
+
+uint8_t World::getLightLevel(int32_t x, int32_t y, int32_t z) {
+    return std::max(getLight(x, y, z, LightChannel::Sky), getLight(x, y, z, LightChannel::Block));
 }
 
 bool World::isBlockOccupied(int32_t x, int32_t y, int32_t z) {
@@ -87,6 +130,31 @@ bool World::isBlockSupported(int32_t x, int32_t y, int32_t z) {
         isBlockOccupied(x, y, z - 1);
 }
 
+// Get the size of the empty cube that a block is in, cubes are aligned to their size. This is the chunk
+// size if the block's chunk is empty, the brick size if its brick is, and 0 otherwise.
+int32_t World::getEmptySpaceSize(int32_t x, int32_t y, int32_t z) {
+    if (x < 0 || x >= mapSize || y < 0 || y >= mapSize || z < 0 || z >= mapSize) return 0;
+
+    Chunk& chunk = getChunk(x / chunkSize, y / chunkSize, z / chunkSize);
+
+    if (chunk.isEmpty()) return chunkSize;
+    if (chunk.isBrickEmpty(x % chunkSize, y % chunkSize, z % chunkSize)) return brickSize;
+
+    return 0;
+}
+
+int32_t World::getChunkSize() {
+    return chunkSize;
+}
+
+int32_t World::getMapSizeInChunks() {
+    return mapSizeInChunks;
+}
+
+int32_t World::getMapSize() {
+    return mapSize;
+}
+
 std::optional<glm::vec3> World::getSpawnPos(int32_t spawnChunkX, int32_t spawnChunkY, int32_t spawnChunkZ, bool force) {
     int32_t spawnChunkWorldX = spawnChunkX * chunkSize;
     int32_t spawnChunkWorldY = spawnChunkY * chunkSize;
@@ -112,7 +180,7 @@ std::optional<glm::vec3> World::getSpawnPos(int32_t spawnChunkX, int32_t spawnCh
         int32_t x = chunkSize / 2;
         int32_t y = chunkSize / 2;
         int32_t z = chunkSize / 2;
-        spawnChunk.setBlock(*this, x, y, z, Blocks::Air);
+        setBlock(spawnChunkWorldX + x, spawnChunkWorldY + y, spawnChunkWorldZ + z, Blocks::Air);
 
         return std::optional<glm::vec3>{{
             spawnChunkWorldX + x + 0.5,
@@ -124,38 +192,20 @@ std::optional<glm::vec3> World::getSpawnPos(int32_t spawnChunkX, int32_t spawnCh
     return std::nullopt;
 }
 
-void World::generate(std::mt19937& rng, siv::BasicPerlinNoise<float>& noise) {
-    for (int32_t z = 0; z < mapSizeInChunks; z++) {
-        for (int32_t y = 0; y < mapSizeInChunks; y++) {
-            for (int32_t x = 0; x < mapSizeInChunks; x++) {
-                getChunk(x, y, z).generate(*this, rng, noise);
-            }
-        }
-    }
-}
+void World::update() {
+    int64_t queuedChunkCount = 0;
 
-void World::draw(Frustum& frustum, VkCommandBuffer commandBuffer) {
     for (int32_t i = 0; i < chunks.size(); i++) {
-        Chunk& chunk = chunks[i];
-        if (frustum.shouldBeCulled(chunk.getPos(), chunk.getSize())) continue;
-        chunk.draw(commandBuffer);
+        if (chunks[i]->isGenerated && chunks[i]->needsUpdate) queuedChunkCount++;
     }
-}
 
-void World::destroy(VmaAllocator allocator) {
-    for (int32_t i = 0; i < chunks.size(); i++) {
-        chunks[i].destroy(allocator);
-    }
-}
+    setGauge(Gauge::MeshQueueDepth, queuedChunkCount);
 
-void World::update(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device) {
     for (int32_t i = 0; i < chunks.size(); i++) {
-        chunks[i].update(*this, allocator, commands, graphicsQueue, device);
-    }
-}
+        // The generator meshes chunks itself until they're done.
+        if (!chunks[i]->isGenerated || !chunks[i]->needsUpdate) continue;
 
-void World::upload(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device) {
-    for (int32_t i = 0; i < chunks.size(); i++) {
-        chunks[i].upload(allocator, commands, graphicsQueue, device);
+        std::lock_guard lock(meshMutex);
+        chunks[i]->update(*this);
     }
 }
\ No newline at end of file
@@ -3,32 +3,53 @@
 #include <vector>
 #include <random>
 #include <optional>
+#include <mutex>
+#include <memory>
 
 #include <glm/glm.hpp>
 
 #include "chunk.hpp"
-#include "frustum.hpp"
+#include "lighting.hpp"
+
+struct BlockEdit {
+    int32_t x, y, z;
+    Blocks block;
+};
 
 class World {
 public:
     World(int32_t chunkSize, int32_t mapSizeInChunks);
     Chunk& getChunk(int32_t x, int32_t y, int32_t z);
     void updateChunk(int32_t x, int32_t y, int32_t z);
+    // Edits relight the columns around them, so while the world is being generated they should only be
+    // made where WorldGenerator::isAreaGenerated says the area is editable.
     void setBlock(int32_t x, int32_t y, int32_t z, Blocks block);
+    // Apply a batch of edits as one change, chunks aren't remeshed until the whole batch is in.
+    // Only the benchmarks call this so far, it's meant for clients applying the server's edit batches.
+    void setBlocks(const std::vector<BlockEdit>& edits);
     Blocks getBlock(int32_t x, int32_t y, int32_t z);
-    bool getLit(int32_t x, int32_t y, int32_t z);
+    void setLight(int32_t x, int32_t y, int32_t z, LightChannel channel, uint8_t level);
+    uint8_t getLight(int32_t x, int32_t y, int32_t z, LightChannel channel);
+    uint8_t getLightLevel(int32_t x, int32_t y, int32_t z);
     bool isBlockOccupied(int32_t x, int32_t y, int32_t z);
     bool isBlockSupported(int32_t x, int32_t y, int32_t z);
+    int32_t getEmptySpaceSize(int32_t x, int32_t y, int32_t z);
+    int32_t getChunkSize();
+    int32_t getMapSizeInChunks();
+    int32_t getMapSize();
     std::optional<glm::vec3> getSpawnPos(int32_t spawnChunkX, int32_t spawnChunkY, int32_t spawnChunkZ, bool force);
-    void generate(std::mt19937& rng, siv::BasicPerlinNoise<float>& noise);
-    void draw(Frustum& frustum, VkCommandBuffer commandBuffer);
-    void destroy(VmaAllocator allocator);
-    void update(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device);
-    void upload(VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device);
+    void update();
 
 private:
+    void setBlockLocked(int32_t x, int32_t y, int32_t z, Blocks block);
+    void updateNeighborChunks(int32_t chunkX, int32_t chunkY, int32_t chunkZ, int32_t localX, int32_t localY, int32_t localZ);
+
     int32_t chunkSize;
     int32_t mapSizeInChunks;
     int32_t mapSize;
-    std::vector<Chunk> chunks;
+    // Chunks have atomic flags so they can't be moved, each one is allocated separately.
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    LightEngine lightEngine;
+    // Held while a chunk is meshed and while edits are applied.
+    std::mutex meshMutex;
 };
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "worldGenerator.hpp"
+
+#include <algorithm>
+
+#include "stats.hpp"
+
+// Lighting a column reads and writes the columns next to it, so two columns can only be lit
+// at the same time when they are far enough apart that those don't overlap.
+constexpr int32_t lightingRadius = 1;
+constexpr int32_t lightingExclusionRadius = 2;
+// A chunk's mesh samples the blocks and light just past its edges. Light fades out before it can
+// cross a whole chunk, so only the columns next to it can still change what the mesh sees.
+constexpr int32_t meshingRadius = 1;
+
+WorldGenerator::WorldGenerator(World& world, ThreadPool& threadPool)
+    : world(world), threadPool(threadPool), mapSizeInChunks(world.getMapSizeInChunks()) {}
+
+void WorldGenerator::start(siv::BasicPerlinNoise<float>& noise, TerrainSettings settings, int32_t priorityChunkX, int32_t priorityChunkZ) {
+    std::lock_guard lock(mutex);
+
+    batchNoise.emplace(noise);
+    this->settings = settings;
+
+    int32_t columnCount = mapSizeInChunks * mapSizeInChunks;
+    int32_t chunkCount = columnCount * mapSizeInChunks;
+
+    heightmaps.assign(columnCount, ColumnHeightmap{});
+    chunkStages.assign(chunkCount, GenerationStage::None);
+    busyChunks.assign(chunkCount, false);
+    busyColumns.assign(columnCount, false);
+    meshedChunkCount = 0;
+    isStopping = false;
+
+    // Jobs are scheduled column by column in this order, so the closest columns finish first.
+    columnOrder.clear();
+
+    for (int32_t chunkZ = 0; chunkZ < mapSizeInChunks; chunkZ++) {
+        for (int32_t chunkX = 0; chunkX < mapSizeInChunks; chunkX++) {
+            columnOrder.push_back(glm::ivec2(chunkX, chunkZ));
+        }
+    }
+
+    glm::ivec2 priorityColumn(priorityChunkX, priorityChunkZ);
+    std::stable_sort(columnOrder.begin(), columnOrder.end(), [&](glm::ivec2 a, glm::ivec2 b) {
+        glm::ivec2 aDistance = a - priorityColumn;
+        glm::ivec2 bDistance = b - priorityColumn;
+        return aDistance.x * aDistance.x + aDistance.y * aDistance.y < bDistance.x * bDistance.x + bDistance.y * bDistance.y;
+    });
+
+    schedule();
+}
+
+void WorldGenerator::wait() {
+    std::unique_lock lock(mutex);
+    jobFinished.wait(lock, [&]() { return meshedChunkCount == static_cast<int32_t>(chunkStages.size()); });
+}
+
+void WorldGenerator::stop() {
+    std::unique_lock lock(mutex);
+    isStopping = true;
+    jobFinished.wait(lock, [&]() { return runningJobCount == 0; });
+}
+
+bool WorldGenerator::isFinished() {
+    std::lock_guard lock(mutex);
+    return meshedChunkCount == static_cast<int32_t>(chunkStages.size());
+}
+
+bool WorldGenerator::isAreaGenerated(int32_t chunkX, int32_t chunkZ, int32_t radius) {
+    std::lock_guard lock(mutex);
+    return isAreaReady(chunkX, chunkZ, radius, GenerationStage::Meshed);
+}
+
+// Start every job whose dependencies are ready, the mutex must be held.
+// Only as many jobs as there are threads are queued at once, otherwise the thread pool would work
+// through everything that became ready earlier before getting to the columns closest to the priority.
+void WorldGenerator::schedule() {
+    if (isStopping) return;
+
+    for (glm::ivec2 column : columnOrder) {
+        if (isPoolFull()) return;
+        scheduleColumn(column.x, column.y);
+    }
+}
+
+bool WorldGenerator::isPoolFull() {
+    return runningJobCount >= static_cast<int32_t>(threadPool.getThreadCount());
+}
+
+void WorldGenerator::scheduleColumn(int32_t chunkX, int32_t chunkZ) {
+    if (busyColumns[getColumnIndex(chunkX, chunkZ)]) return;
+
+    GenerationStage columnStage = getColumnStage(chunkX, chunkZ);
+
+    switch (columnStage) {
+    case GenerationStage::None:
+        busyColumns[getColumnIndex(chunkX, chunkZ)] = true;
+        runningJobCount++;
+        threadPool.enqueue([=]() { runColumnJob(chunkX, chunkZ, GenerationStage::Heightmap); });
+        return;
+    case GenerationStage::Caves:
+        if (isAreaReady(chunkX, chunkZ, lightingRadius, GenerationStage::Caves) && !isAreaBeingLit(chunkX, chunkZ, lightingExclusionRadius)) {
+            busyColumns[getColumnIndex(chunkX, chunkZ)] = true;
+            runningJobCount++;
+            threadPool.enqueue([=]() { runColumnJob(chunkX, chunkZ, GenerationStage::Lit); });
+        }
+        return;
+    default:
+        break;
+    }
+
+    // The remaining stages only touch a single chunk.
+    for (int32_t chunkY = 0; chunkY < mapSizeInChunks; chunkY++) {
+        if (isPoolFull()) return;
+
+        int32_t i = getChunkIndex(chunkX, chunkY, chunkZ);
+        if (busyChunks[i]) continue;
+
+        GenerationStage nextStage;
+
+        switch (chunkStages[i]) {
+        case GenerationStage::Heightmap:
+            nextStage = GenerationStage::Terrain;
+            break;
+        case GenerationStage::Terrain:
+            nextStage = GenerationStage::Caves;
+            break;
+        case GenerationStage::Lit:
+            if (!isAreaReady(chunkX, chunkZ, meshingRadius, GenerationStage::Lit)) continue;
+            nextStage = GenerationStage::Meshed;
+            break;
+        default:
+            continue;
+        }
+
+        busyChunks[i] = true;
+        runningJobCount++;
+        threadPool.enqueue([=]() { runChunkJob(chunkX, chunkY, chunkZ, nextStage); });
+    }
+}
+
+void WorldGenerator::runColumnJob(int32_t chunkX, int32_t chunkZ, GenerationStage stage) {
+    int32_t chunkSize = world.getChunkSize();
+
+    switch (stage) {
+    case GenerationStage::Heightmap:
+        heightmaps[getColumnIndex(chunkX, chunkZ)] = generateHeightmap(*batchNoise, chunkSize, chunkX * chunkSize, chunkZ * chunkSize);
+        break;
+    case GenerationStage::Lit: {
+        // Each job gets its own engine, the queues inside are not shared between threads.
+        LightEngine lightEngine;
+        lightEngine.lightColumn(world, chunkX, chunkZ);
+        break;
+    }
+    default:
+        break;
+    }
+
+    finishColumnJob(chunkX, chunkZ, stage);
+}
+
+void WorldGenerator::runChunkJob(int32_t chunkX, int32_t chunkY, int32_t chunkZ, GenerationStage stage) {
+    Chunk& chunk = world.getChunk(chunkX, chunkY, chunkZ);
+    ColumnHeightmap& heightmap = heightmaps[getColumnIndex(chunkX, chunkZ)];
+
+    switch (stage) {
+    case GenerationStage::Terrain:
+        chunk.generateTerrain(heightmap);
+        break;
+    case GenerationStage::Caves:
+        chunk.generateCaves(*batchNoise, settings, heightmap);
+        break;
+    case GenerationStage::Meshed:
+        chunk.update(world);
+        break;
+    default:
+        break;
+    }
+
+    finishChunkJob(chunkX, chunkY, chunkZ, stage);
+}
+
+void WorldGenerator::finishColumnJob(int32_t chunkX, int32_t chunkZ, GenerationStage stage) {
+    std::lock_guard lock(mutex);
+
+    for (int32_t chunkY = 0; chunkY < mapSizeInChunks; chunkY++) {
+        chunkStages[getChunkIndex(chunkX, chunkY, chunkZ)] = stage;
+    }
+
+    busyColumns[getColumnIndex(chunkX, chunkZ)] = false;
+    runningJobCount--;
+    jobFinished.notify_all();
+
+    schedule();
+}
+
+void WorldGenerator::finishChunkJob(int32_t chunkX, int32_t chunkY, int32_t chunkZ, GenerationStage stage) {
+    std::lock_guard lock(mutex);
+
+    int32_t i = getChunkIndex(chunkX, chunkY, chunkZ);
+    chunkStages[i] = stage;
+    busyChunks[i] = false;
+    runningJobCount--;
+
+    if (stage == GenerationStage::Meshed) {
+        // From here on the chunk belongs to the world, which keeps its mesh up to date.
+        world.getChunk(chunkX, chunkY, chunkZ).isGenerated = true;
+        meshedChunkCount++;
+        addCounter(Counter::ChunksGenerated);
+    }
+
+    jobFinished.notify_all();
+    schedule();
+}
+
+// A column is only as far along as its least generated chunk.
+GenerationStage WorldGenerator::getColumnStage(int32_t chunkX, int32_t chunkZ) {
+    GenerationStage stage = GenerationStage::Meshed;
+
+    for (int32_t chunkY = 0; chunkY < mapSizeInChunks; chunkY++) {
+        stage = std::min(stage, chunkStages[getChunkIndex(chunkX, chunkY, chunkZ)]);
+    }
+
+    return stage;
+}
+
+bool WorldGenerator::isAreaReady(int32_t chunkX, int32_t chunkZ, int32_t radius, GenerationStage stage) {
+    int32_t minX = std::max(chunkX - radius, 0);
+    int32_t minZ = std::max(chunkZ - radius, 0);
+    int32_t maxX = std::min(chunkX + radius, mapSizeInChunks - 1);
+    int32_t maxZ = std::min(chunkZ + radius, mapSizeInChunks - 1);
+
+    for (int32_t z = minZ; z <= maxZ; z++) {
+        for (int32_t x = minX; x <= maxX; x++) {
+            if (getColumnStage(x, z) < stage) return false;
+        }
+    }
+
+    return true;
+}
+
+bool WorldGenerator::isAreaBeingLit(int32_t chunkX, int32_t chunkZ, int32_t radius) {
+    int32_t minX = std::max(chunkX - radius, 0);
+    int32_t minZ = std::max(chunkZ - radius, 0);
+    int32_t maxX = std::min(chunkX + radius, mapSizeInChunks - 1);
+    int32_t maxZ = std::min(chunkZ + radius, mapSizeInChunks - 1);
+
+    for (int32_t z = minZ; z <= maxZ; z++) {
+        for (int32_t x = minX; x <= maxX; x++) {
+            // Busy columns that have their caves are being lit, earlier column jobs don't touch the world.
+            if (busyColumns[getColumnIndex(x, z)] && getColumnStage(x, z) == GenerationStage::Caves) return true;
+        }
+    }
+
+    return false;
+}
+
+int32_t WorldGenerator::getChunkIndex(int32_t chunkX, int32_t chunkY, int32_t chunkZ) {
+    return chunkX + chunkY * mapSizeInChunks + chunkZ * mapSizeInChunks * mapSizeInChunks;
+}
+
+int32_t WorldGenerator::getColumnIndex(int32_t chunkX, int32_t chunkZ) {
+    return chunkX + chunkZ * mapSizeInChunks;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+
+#include <glm/glm.hpp>
+
+#include "../deps/perlinNoise.hpp"
+
+#include "world.hpp"
+#include "threadPool.hpp"
+#include "batchNoise.hpp"
+#include "terrainNoise.hpp"
+
+// Relighting an edit reaches into the surrounding columns, and those are lit by the columns around them.
+// Blocks can be edited once every column within this radius is generated, without racing the generator.
+constexpr int32_t editableAreaRadius = 2;
+
+// The steps a chunk goes through while it is generated, in order.
+enum class GenerationStage {
+    None,
+    Heightmap,
+    Terrain,
+    Caves,
+    Lit,
+    Meshed,
+};
+
+// Generates the world in stages on the thread pool. Each stage of a chunk runs as soon as the chunks
+// it reads from are far enough along, instead of waiting for the whole world to finish the previous stage.
+class WorldGenerator {
+public:
+    WorldGenerator(World& world, ThreadPool& threadPool);
+    // Columns closest to the priority column are generated first.
+    void start(siv::BasicPerlinNoise<float>& noise, TerrainSettings settings, int32_t priorityChunkX, int32_t priorityChunkZ);
+    void wait();
+    // Let the jobs that are already running finish without starting any new ones.
+    void stop();
+    bool isFinished();
+    // Check if every column within radius has been meshed.
+    bool isAreaGenerated(int32_t chunkX, int32_t chunkZ, int32_t radius);
+
+private:
+    void schedule();
+    void scheduleColumn(int32_t chunkX, int32_t chunkZ);
+    bool isPoolFull();
+    void runColumnJob(int32_t chunkX, int32_t chunkZ, GenerationStage stage);
+    void runChunkJob(int32_t chunkX, int32_t chunkY, int32_t chunkZ, GenerationStage stage);
+    void finishColumnJob(int32_t chunkX, int32_t chunkZ, GenerationStage stage);
+    void finishChunkJob(int32_t chunkX, int32_t chunkY, int32_t chunkZ, GenerationStage stage);
+    GenerationStage getColumnStage(int32_t chunkX, int32_t chunkZ);
+    // Check that every column within radius has reached stage.
+    bool isAreaReady(int32_t chunkX, int32_t chunkZ, int32_t radius, GenerationStage stage);
+    bool isAreaBeingLit(int32_t chunkX, int32_t chunkZ, int32_t radius);
+    int32_t getChunkIndex(int32_t chunkX, int32_t chunkY, int32_t chunkZ);
+    int32_t getColumnIndex(int32_t chunkX, int32_t chunkZ);
+
+    World& world;
+    ThreadPool& threadPool;
+    std::optional<BatchNoise> batchNoise;
+    TerrainSettings settings;
+    int32_t mapSizeInChunks;
+
+    std::vector<glm::ivec2> columnOrder;
+    std::vector<ColumnHeightmap> heightmaps;
+    std::vector<GenerationStage> chunkStages;
+    std::vector<bool> busyChunks;
+    std::vector<bool> busyColumns;
+    int32_t meshedChunkCount = 0;
+    int32_t runningJobCount = 0;
+    bool isStopping = false;
+
+    std::mutex mutex;
+    std::condition_variable jobFinished;
+};
\ No newline at end of file
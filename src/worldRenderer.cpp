@@ -0,0 +1,74 @@
+#include "worldRenderer.hpp"
+
+#include "profiler.hpp"
+#include "stats.hpp"
+
+void WorldRenderer::upload(World& world, VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device) {
+    int32_t mapSizeInChunks = world.getMapSizeInChunks();
+    size_t chunkCount = mapSizeInChunks * mapSizeInChunks * mapSizeInChunks;
+
+    if (chunkModels.size() != chunkCount) {
+        chunkModels.resize(chunkCount);
+        uploadedChunks.resize(chunkCount, false);
+    }
+
+    for (int32_t z = 0; z < mapSizeInChunks; z++) {
+        for (int32_t y = 0; y < mapSizeInChunks; y++) {
+            for (int32_t x = 0; x < mapSizeInChunks; x++) {
+                Chunk& chunk = world.getChunk(x, y, z);
+                if (!chunk.needsUpload) continue;
+
+                PROFILE_ZONE("uploadMesh");
+
+                size_t i = x + y * mapSizeInChunks + z * mapSizeInChunks * mapSizeInChunks;
+                Model<VertexData, uint32_t, InstanceData>& model = chunkModels[i];
+
+                if (!uploadedChunks[i]) {
+                    model = Model<VertexData, uint32_t, InstanceData>::fromVerticesAndIndices(chunk.getVertices(), chunk.getIndices(), 1,
+                        allocator, commands, graphicsQueue, device);
+                    std::vector<InstanceData> instances{InstanceData{chunk.getPos()}};
+                    model.updateInstances(instances, commands, allocator, graphicsQueue, device);
+                    uploadedChunks[i] = true;
+                }
+                else {
+                    model.update(chunk.getVertices(), chunk.getIndices(), commands, allocator, graphicsQueue, device);
+                }
+
+                addCounter(Counter::BytesUploaded, chunk.getVertices().size() * sizeof(VertexData) + chunk.getIndices().size() * sizeof(uint32_t));
+                chunk.needsUpload = false;
+            }
+        }
+    }
+}
+
+void WorldRenderer::draw(World& world, Frustum& frustum, VkCommandBuffer commandBuffer) {
+    PROFILE_ZONE("WorldRenderer::draw");
+
+    int32_t mapSizeInChunks = world.getMapSizeInChunks();
+
+    for (int32_t z = 0; z < mapSizeInChunks; z++) {
+        for (int32_t y = 0; y < mapSizeInChunks; y++) {
+            for (int32_t x = 0; x < mapSizeInChunks; x++) {
+                size_t i = x + y * mapSizeInChunks + z * mapSizeInChunks * mapSizeInChunks;
+                if (i >= uploadedChunks.size() || !uploadedChunks[i]) continue;
+
+                Chunk& chunk = world.getChunk(x, y, z);
+                if (frustum.shouldBeCulled(chunk.getPos(), chunk.getSize())) {
+                    addCounter(Counter::ChunksCulled);
+                    continue;
+                }
+
+                chunkModels[i].draw(commandBuffer);
+                addCounter(Counter::DrawCalls);
+            }
+        }
+    }
+}
+
+void WorldRenderer::destroy(VmaAllocator allocator) {
+    for (size_t i = 0; i < chunkModels.size(); i++) {
+        if (!uploadedChunks[i]) continue;
+
+        chunkModels[i].destroy(allocator);
+    }
+}
\ No newline at end of file
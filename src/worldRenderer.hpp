@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include <vkFrame/renderer.hpp>
+
+#include "world.hpp"
+#include "frustum.hpp"
+#include "renderTypes.hpp"
+
+// Keeps a GPU model for each chunk in the world, uploading chunk meshes after they change.
+class WorldRenderer {
+public:
+    void upload(World& world, VmaAllocator allocator, Commands& commands, VkQueue graphicsQueue, VkDevice device);
+    void draw(World& world, Frustum& frustum, VkCommandBuffer commandBuffer);
+    void destroy(VmaAllocator allocator);
+
+private:
+    std::vector<Model<VertexData, uint32_t, InstanceData>> chunkModels;
+    // Chunks that are still being generated don't have a model yet.
+    std::vector<bool> uploadedChunks;
+};
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include <cstdio>
+#include <cstring>
+#include <cinttypes>
+#include <random>
+#include <vector>
+
+#include "../src/batchNoise.hpp"
+
+// Checks that BatchNoise matches the scalar siv::BasicPerlinNoise bit for bit. The same test is built
+// once for the default SSE2 path and once with AVX2 when MPVOXELS_AVX2 is on.
+
+constexpr uint32_t seed = 123;
+
+// Points that end in a partial batch, so the scalar tail is checked along with the vector path.
+constexpr size_t randomPointCount = 100003;
+
+static bool isSameFloat(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+int main() {
+    siv::BasicPerlinNoise<float> noise{seed};
+    BatchNoise batchNoise(noise);
+
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> zs;
+
+    // Integer coordinates sit exactly on the lattice, where the floor and wrapping are easiest to get wrong.
+    for (int32_t z = -3; z <= 3; z++) {
+        for (int32_t y = -3; y <= 3; y++) {
+            for (int32_t x = -3; x <= 3; x++) {
+                xs.push_back(static_cast<float>(x * 97));
+                ys.push_back(static_cast<float>(y * 53));
+                zs.push_back(static_cast<float>(z * 131));
+            }
+        }
+    }
+
+    // Values just next to integers, on both sides of zero.
+    const float edgeValues[] = { -256.0f, -1.0f, -0.5f, -1e-6f, 0.0f, 1e-6f, 0.5f, 0.999999f, 255.5f, 256.0f };
+    for (float x : edgeValues) {
+        for (float y : edgeValues) {
+            for (float z : edgeValues) {
+                xs.push_back(x);
+                ys.push_back(y);
+                zs.push_back(z);
+            }
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> distribution(-300.0f, 300.0f);
+
+    for (size_t i = 0; i < randomPointCount; i++) {
+        xs.push_back(distribution(rng));
+        ys.push_back(distribution(rng));
+        zs.push_back(distribution(rng));
+    }
+
+    size_t count = xs.size();
+    std::vector<float> results(count);
+    size_t mismatchCount = 0;
+
+    batchNoise.noise3D_01(xs.data(), ys.data(), zs.data(), results.data(), count);
+
+    for (size_t i = 0; i < count; i++) {
+        float expected = noise.noise3D_01(xs[i], ys[i], zs[i]);
+        if (isSameFloat(results[i], expected)) continue;
+
+        if (mismatchCount == 0) {
+            std::printf("noise3D_01(%.9g, %.9g, %.9g) is %.9g, expected %.9g\n", xs[i], ys[i], zs[i], results[i], expected);
+        }
+
+        mismatchCount++;
+    }
+
+    batchNoise.noise2D_01(xs.data(), ys.data(), results.data(), count);
+
+    for (size_t i = 0; i < count; i++) {
+        float expected = noise.noise2D_01(xs[i], ys[i]);
+        if (isSameFloat(results[i], expected)) continue;
+
+        if (mismatchCount == 0) {
+            std::printf("noise2D_01(%.9g, %.9g) is %.9g, expected %.9g\n", xs[i], ys[i], results[i], expected);
+        }
+
+        mismatchCount++;
+    }
+
+    std::printf("%zu mismatches in %zu points\n", mismatchCount, count * 2);
+
+    return mismatchCount == 0 ? 0 : 1;
+}
\ No newline at end of file
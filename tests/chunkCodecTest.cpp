@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <cstring>
+#include <cinttypes>
+#include <random>
+#include <vector>
+#include <string>
+
+#include "../src/world.hpp"
+#include "../src/worldGenerator.hpp"
+#include "../src/chunkCodec.hpp"
+#include "../src/threadPool.hpp"
+
+// Checks that chunks come back unchanged after being encoded and decoded, with each of the encodings.
+
+constexpr int32_t seed = 123;
+constexpr int32_t chunkSize = 32;
+constexpr int32_t mapSizeInChunks = 4;
+constexpr int32_t chunkBlockCount = chunkSize * chunkSize * chunkSize;
+
+static int32_t failureCount = 0;
+
+static void fail(const std::string& name, const char* message) {
+    std::printf("%s: %s\n", name.c_str(), message);
+    failureCount++;
+}
+
+// Round trip blocks through the codec, then make sure no shorter prefix of the encoded data is accepted.
+static void checkRoundTrip(ChunkCodec& codec, const std::string& name, const std::vector<Blocks>& blocks,
+                           ChunkEncoding expectedEncoding) {
+    std::vector<uint8_t> data;
+    codec.encode(blocks.data(), data);
+
+    if (static_cast<ChunkEncoding>(data[0]) != expectedEncoding) {
+        fail(name, "used an unexpected encoding");
+    }
+
+    std::vector<Blocks> decodedBlocks(blocks.size());
+
+    if (!codec.decode(data.data(), data.size(), decodedBlocks.data())) {
+        fail(name, "failed to decode");
+        return;
+    }
+
+    if (decodedBlocks != blocks) {
+        fail(name, "decoded to different blocks");
+    }
+
+    for (size_t size = 0; size < data.size(); size++) {
+        if (codec.decode(data.data(), size, decodedBlocks.data())) {
+            fail(name, "accepted truncated data");
+            return;
+        }
+    }
+}
+
+int main() {
+    ChunkCodec codec(chunkSize);
+
+    // Terrain, where most chunks are runs of the same block down each column.
+    ThreadPool threadPool;
+    World world(chunkSize, mapSizeInChunks);
+    siv::BasicPerlinNoise<float> noise{seed};
+    WorldGenerator worldGenerator(world, threadPool);
+    worldGenerator.start(noise, TerrainSettings{}, 0, 0);
+    worldGenerator.wait();
+    bool hasRuns = false;
+
+    for (int32_t z = 0; z < mapSizeInChunks; z++) {
+        for (int32_t y = 0; y < mapSizeInChunks; y++) {
+            for (int32_t x = 0; x < mapSizeInChunks; x++) {
+                const Blocks* chunkBlocks = world.getChunk(x, y, z).getBlockData();
+                std::vector<Blocks> blocks(chunkBlocks, chunkBlocks + chunkBlockCount);
+                std::string name = "chunk " + std::to_string(x) + " " + std::to_string(y) + " " + std::to_string(z);
+
+                std::vector<uint8_t> data;
+                codec.encode(blocks.data(), data);
+                ChunkEncoding encoding = static_cast<ChunkEncoding>(data[0]);
+                hasRuns = hasRuns || encoding == ChunkEncoding::Runs;
+                checkRoundTrip(codec, name, blocks, encoding);
+            }
+        }
+    }
+
+    if (!hasRuns) {
+        fail("terrain", "didn't use runs for any chunk");
+    }
+
+    // Only one block type, so palette indices take no bits at all and the chunk is just its palette.
+    checkRoundTrip(codec, "air chunk", std::vector<Blocks>(chunkBlockCount, Blocks::Air), ChunkEncoding::Packed);
+    checkRoundTrip(codec, "stone chunk", std::vector<Blocks>(chunkBlockCount, Blocks::Stone), ChunkEncoding::Packed);
+
+    // Every block is random, so runs don't help.
+    std::mt19937 rng{seed};
+    std::vector<Blocks> noisyBlocks(chunkBlockCount);
+
+    for (Blocks& block : noisyBlocks) {
+        block = static_cast<Blocks>(rng() % blockTypeCount);
+    }
+
+    checkRoundTrip(codec, "noisy chunk", noisyBlocks, ChunkEncoding::Packed);
+
+    // With so few block types, packing always beats raw bytes unless the palette header outweighs the blocks.
+    ChunkCodec singleBlockCodec(1);
+    checkRoundTrip(singleBlockCodec, "single block chunk", std::vector<Blocks>(1, Blocks::Dirt), ChunkEncoding::Raw);
+
+    std::printf("%d failures\n", failureCount);
+
+    return failureCount == 0 ? 0 : 1;
+}
\ No newline at end of file